@@ -0,0 +1,69 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::uint64_t> s_Allocations    = 0;
+static std::atomic<std::uint64_t> s_AllocatedBytes = 0;
+
+static thread_local std::uint64_t t_AllocatedBytes = 0;
+
+static void* CountedAlloc(std::size_t size)
+{
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	t_AllocatedBytes += size;
+	void* ptr = std::malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(std::size_t size)
+{
+	return CountedAlloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return CountedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+	std::free(ptr);
+}
+
+namespace AllocationCounter
+{
+	std::uint64_t Allocations()
+	{
+		return s_Allocations.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t AllocatedBytes()
+	{
+		return s_AllocatedBytes.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t ThreadAllocatedBytes()
+	{
+		return t_AllocatedBytes;
+	}
+} // namespace AllocationCounter
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts every call to the global operator new, used to check that steady-state compiles stay off the heap
+namespace AllocationCounter
+{
+	std::uint64_t Allocations();
+	std::uint64_t AllocatedBytes();
+	// Bytes allocated by the calling thread only, for attributing allocations to work running concurrently
+	std::uint64_t ThreadAllocatedBytes();
+} // namespace AllocationCounter
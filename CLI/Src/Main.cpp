@@ -1,8 +1,19 @@
+#include "AllocationCounter.h"
+
+#include <Frertex/AST/Dump.h>
+#include <Frertex/AST/SubtreeHash.h>
+#include <Frertex/AST/Visitor.h>
+#include <Frertex/Cache/Cache.h>
 #include <Frertex/Compiler/Compiler.h>
 #include <Frertex/Parser/Parser.h>
 #include <Frertex/Tokenizer/Tokenizer.h>
+#include <Frertex/Utils/Hash.h>
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <string>
 
@@ -38,33 +49,6 @@ private:
 #endif
 };
 
-std::string Escape(std::string_view escape)
-{
-	std::string result {};
-	std::size_t offset      = 0;
-	std::size_t nextQuote   = escape.find_first_of('\'', offset);
-	std::size_t nextNewline = escape.find_first_of('\n', offset);
-	while ((nextQuote != std::string_view::npos || nextNewline != std::string_view::npos) && offset < escape.size())
-	{
-		std::size_t closest = std::min(nextQuote, nextNewline);
-		result              += escape.substr(offset, closest - offset);
-		offset              = closest + 1;
-		if (closest == nextQuote)
-		{
-			result    += "\\'";
-			nextQuote = escape.find_first_of('\'', offset);
-		}
-		else
-		{
-			result      += "\\n";
-			nextNewline = escape.find_first_of('\n', offset);
-		}
-	}
-	if (offset < escape.size())
-		result += escape.substr(offset);
-	return result;
-}
-
 std::int32_t TimeRescale(std::int32_t scale)
 {
 	if (scale < -30)
@@ -117,23 +101,36 @@ std::string PrettyDuration(std::chrono::duration<Rep, Period> duration)
 	return fmt::format("{:>7.3f} {:<2}", dur, TimeSuffix(scale));
 }
 
-void PrintASTNode(const Frertex::AST::AST& ast, std::uint64_t node, std::string_view source)
+bool SameTokens(const std::vector<Frertex::Tokenizer::Token>& lhs, const std::vector<Frertex::Tokenizer::Token>& rhs)
 {
-	std::string prefix;
-	Frertex::AST::WalkASTNode(
-		ast,
-		node,
-		[&]([[maybe_unused]] const Frertex::AST::AST& ast2, [[maybe_unused]] std::uint64_t index, const Frertex::AST::Node& node2) -> Frertex::AST::EWalkerResult {
-			std::cout << prefix << Frertex::AST::TypeToString(node2.Type) << "(" << node2.Token.Start << " -> " << (node2.Token.Start + node2.Token.Length) << "): '" << Escape(source.substr(node2.Token.Start, node2.Token.Length)) << "'\n";
-			prefix.push_back(' ');
-			prefix.push_back(' ');
-			return Frertex::AST::EWalkerResult::Continue;
-		},
-		[&]([[maybe_unused]] const Frertex::AST::AST& ast2, [[maybe_unused]] std::uint64_t index, [[maybe_unused]] const Frertex::AST::Node& node2) -> Frertex::AST::EWalkerResult {
-			prefix.pop_back();
-			prefix.pop_back();
-			return Frertex::AST::EWalkerResult::Continue;
-		});
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const Frertex::Tokenizer::Token& a, const Frertex::Tokenizer::Token& b) {
+		return a.Class == b.Class && a.Start == b.Start && a.Length == b.Length;
+	});
+}
+
+bool SameAST(const Frertex::AST::AST& lhs, const Frertex::AST::AST& rhs)
+{
+	// Compares structure, node indices and leaked nodes may differ
+	std::vector<std::pair<std::uint64_t, std::uint64_t>> stack { { lhs.RootNode(), rhs.RootNode() } };
+	while (!stack.empty())
+	{
+		auto [a, b] = stack.back();
+		stack.pop_back();
+		if (a == ~0ULL || b == ~0ULL)
+		{
+			if (a != b)
+				return false;
+			continue;
+		}
+
+		auto& nodeA = lhs[a];
+		auto& nodeB = rhs[b];
+		if (nodeA.Type != nodeB.Type || nodeA.Token.Start != nodeB.Token.Start || nodeA.Token.Length != nodeB.Token.Length)
+			return false;
+		stack.emplace_back(nodeA.NextSibling, nodeB.NextSibling);
+		stack.emplace_back(nodeA.Child, nodeB.Child);
+	}
+	return true;
 }
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
@@ -157,6 +154,28 @@ void Frag(in float2 inUV,
 	for (std::size_t i = 0; i < 16; ++i)
 		test += test;
 
+	// The compiler sections need bodies to lower, the sections before them keep the input above so their numbers stay comparable
+	std::string codegenTest = R"([[VertexShader]]
+void Vert(in float4 inPosition,
+          in float4 inNormal,
+          [[Position]] out float4 outPosition,
+          out float2 outUV)
+{
+	outPosition = inPosition + inNormal * 0.5;
+	outUV       = inPosition * 0.5 + 0.5;
+}
+
+[[FragmentShader]]
+void Frag(in float2 inUV,
+          out float4 outColor)
+{
+	outColor = inUV * 2.0 - 1.0;
+}
+)";
+	const std::string unit = codegenTest;
+	for (std::size_t i = 0; i < 16; ++i)
+		codegenTest += codegenTest;
+
 	using Clock    = std::chrono::high_resolution_clock;
 	using Duration = std::chrono::duration<double>;
 
@@ -165,8 +184,9 @@ void Frag(in float2 inUV,
 	auto start = Clock::now();
 
 	std::vector<Frertex::Tokenizer::Token> tokens;
+	Frertex::Tokenizer::SourceMap          sourceMap;
 
-	auto iters = Frertex::Tokenizer::Tokenize(test.c_str(), test.size(), tokens);
+	auto iters = Frertex::Tokenizer::Tokenize(test.c_str(), test.size(), tokens, sourceMap);
 
 	auto end = Clock::now();
 	std::cout << "Iterations: " << iters << "\n";
@@ -174,12 +194,63 @@ void Frag(in float2 inUV,
 	std::cout << "Avg time per iter:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / iters) << "\n";
 	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / test.size()) << "\n";
 	std::cout << "Avg time per token: " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / tokens.size()) << "\n";
+	std::cout << "Lines: " << sourceMap.LineCount() << "\n";
 	std::cout << "Tokens (" << tokens.size() << "):\n";
-	/*for (std::size_t i = 0; i < tokens.size(); ++i)
-	{
-		auto token = tokens[i];
-		std::cout << Frertex::Tokenizer::TokenClassToString(token.Class) << " (" << token.Start << " -> " << (token.Start + token.Length - 1) << "): '" << Escape(test.substr(token.Start, token.Length)) << "'\n";
-	}*/
+	// Frertex::AST::Dumper(stdout).DumpTokens(tokens, test);
+	std::cout << "----------------\n";
+
+	std::cout << "- Tokenizer x4 -\n";
+	start = Clock::now();
+
+	std::vector<Frertex::Tokenizer::Token> interleavedTokens;
+
+	iters = Frertex::Tokenizer::TokenizeInterleaved(test.c_str(), test.size(), interleavedTokens, 4);
+
+	end = Clock::now();
+	std::cout << "Iterations: " << iters << "\n";
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / test.size()) << "\n";
+	std::cout << "Avg time per token: " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / interleavedTokens.size()) << "\n";
+	std::cout << "Matches: " << (SameTokens(tokens, interleavedTokens) ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "- Tokenizer BL -\n";
+	std::vector<Frertex::Tokenizer::Token> loopTokens;
+	start = Clock::now();
+	Frertex::Tokenizer::Tokenize(test.c_str(), test.size(), loopTokens);
+	end           = Clock::now();
+	auto loopTime = end - start;
+
+	std::vector<Frertex::Tokenizer::Token> branchlessTokens;
+	start = Clock::now();
+	iters = Frertex::Tokenizer::TokenizeBranchless(test.c_str(), test.size(), branchlessTokens);
+	end   = Clock::now();
+
+	std::cout << "Iterations: " << iters << "\n";
+	std::cout << "Loop time:          " << PrettyDuration(loopTime) << "\n";
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / test.size()) << "\n";
+	std::cout << "Avg time per token: " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / branchlessTokens.size()) << "\n";
+	std::cout << "Matches: " << (SameTokens(tokens, branchlessTokens) ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "- Retokenizer --\n";
+	std::string edited     = test;
+	std::size_t editOffset = edited.find("outUV", edited.size() / 2);
+	edited.replace(editOffset, 5, "outTexCoord");
+
+	std::vector<Frertex::Tokenizer::Token> retokenized = tokens;
+	start                                              = Clock::now();
+
+	auto retokenize = Frertex::Tokenizer::Retokenize(edited.c_str(), edited.size(), retokenized, { .Offset = editOffset, .RemovedLength = 5, .InsertedLength = 11 });
+
+	end = Clock::now();
+	std::vector<Frertex::Tokenizer::Token> editedTokens;
+	Frertex::Tokenizer::Tokenize(edited.c_str(), edited.size(), editedTokens);
+	std::cout << "Iterations: " << retokenize.Iterations << "\n";
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Tokens replaced: " << retokenize.RemovedTokens << " -> " << retokenize.InsertedTokens << "\n";
+	std::cout << "Matches: " << (SameTokens(retokenized, editedTokens) ? "yes" : "no") << "\n";
 	std::cout << "----------------\n";
 
 	std::cout << "---- Parser ----\n";
@@ -193,18 +264,485 @@ void Frag(in float2 inUV,
 	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / test.size()) << "\n";
 	std::cout << "Avg time per node:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / AST.Size()) << "\n";
 	std::cout << "AST (" << AST.Size() << "):\n";
-	// PrintASTNode(AST, AST.RootNode(), test);
+	// Frertex::AST::Dumper(stdout).DumpAST(AST, AST.RootNode(), test);
 	std::cout << "----------------\n";
 
-	std::cout << "--- Compiler ---\n";
+#if FRERTEX_PARSER_PROFILING
+	std::cout << "- Parser rules -\n";
+	parser.ResetProfile();
+	parser.Parse(test, tokens);
+
+	const Frertex::Parser::Profile& profile = parser.GetProfile();
+
+	std::vector<Frertex::Parser::ERule> rules;
+	for (std::size_t i = 0; i < profile.Rules.size(); ++i)
+		if (profile.Rules[i].Attempts)
+			rules.emplace_back(static_cast<Frertex::Parser::ERule>(i));
+	std::sort(rules.begin(), rules.end(), [&](Frertex::Parser::ERule lhs, Frertex::Parser::ERule rhs) {
+		return profile[lhs].Nanoseconds > profile[rhs].Nanoseconds;
+	});
+
+	std::cout << fmt::format("{:<22} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n", "Rule", "Attempts", "Successes", "Tokens", "Allocated", "Freed", "Time");
+	for (auto rule : rules)
+	{
+		auto& stats = profile[rule];
+		std::cout << fmt::format("{:<22} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+								 Frertex::Parser::RuleToString(rule),
+								 stats.Attempts,
+								 stats.Successes,
+								 stats.TokensConsumed,
+								 stats.NodesAllocated,
+								 stats.NodesFreed,
+								 PrettyDuration(std::chrono::nanoseconds(stats.Nanoseconds)));
+	}
+	std::cout << "----------------\n";
+#endif
+
+	std::cout << "- Expressions --\n";
+	// One long left associative chain and one deeply nested right hand side, neither may cost parser recursion
+	constexpr std::size_t c_ChainTerms = 1 << 18;
+	constexpr char        c_ChainOps[] = { '+', '*', '-', '/' };
+
+	std::string chain = "void Chain()\n{\n\tx = 1";
+	for (std::size_t i = 1; i < c_ChainTerms; ++i)
+		chain += fmt::format(" {} {}", c_ChainOps[i & 3], i);
+	chain += ";\n\ty = ";
+	for (std::size_t i = 1; i < c_ChainTerms; ++i)
+		chain += fmt::format("{} - (", i);
+	chain += "0";
+	chain.append(c_ChainTerms - 1, ')');
+	chain += ";\n}\n";
+
+	std::vector<Frertex::Tokenizer::Token> chainTokens;
+	Frertex::Tokenizer::Tokenize(chain.c_str(), chain.size(), chainTokens);
 	start = Clock::now();
 
-	Frertex::Compiler::State compiler;
-	Frertex::FIL::Binary     FIL = compiler.Compile(test, AST);
+	Frertex::AST::AST chainAST = parser.Parse(chain, chainTokens);
+
+	end = Clock::now();
+	std::cout << "Terms: " << (2 * c_ChainTerms) << ", tokens: " << chainTokens.size() << "\n";
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Avg time per token: " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / chainTokens.size()) << "\n";
+	std::cout << "Avg time per node:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / chainAST.Size()) << "\n";
+	std::cout << "AST (" << chainAST.Size() << ")\n";
+
+	// A syntax error at the end of the chain backtracks over all of it
+	std::string brokenChain = chain;
+	brokenChain.insert(brokenChain.find(';'), " +");
+	std::vector<Frertex::Tokenizer::Token> brokenChainTokens;
+	Frertex::Tokenizer::Tokenize(brokenChain.c_str(), brokenChain.size(), brokenChainTokens);
+	start = Clock::now();
+
+	Frertex::AST::AST brokenChainAST = parser.Parse(brokenChain, brokenChainTokens);
+
+	end = Clock::now();
+	std::cout << "Syntax error time:  " << PrettyDuration(end - start) << "\n";
+	std::cout << "Syntax error AST (" << brokenChainAST.Size() << ")\n";
+	std::cout << "----------------\n";
+
+	std::cout << "-- Pipelined ---\n";
+	start = Clock::now();
+
+	Frertex::AST::AST pipelinedAST = parser.ParsePipelined(test);
+
+	end = Clock::now();
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / test.size()) << "\n";
+	std::cout << "Avg time per node:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / pipelinedAST.Size()) << "\n";
+	std::cout << "Matches: " << (pipelinedAST.Size() == AST.Size() ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "- Lazy Parser --\n";
+	start = Clock::now();
+
+	Frertex::AST::AST lazyAST = parser.Parse(test, tokens, { .LazyFunctionBodies = true });
 
 	end = Clock::now();
 	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
 	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / test.size()) << "\n";
+	std::cout << "Nodes: " << lazyAST.Size() << "\n";
+
+	// Copied, expanding a body changes its type and with it the index
+	auto                       lazyView = lazyAST.NodesOfType(Frertex::AST::EType::LazyCompoundStatement);
+	std::vector<std::uint64_t> lazyBodies(lazyView.begin(), lazyView.end());
+
+	start = Clock::now();
+	for (auto body : lazyBodies)
+		parser.ExpandLazyBody(lazyAST, body, test, tokens);
+	end = Clock::now();
+	std::cout << "Expand time:        " << PrettyDuration(end - start) << "\n";
+	std::cout << "Matches: " << (SameAST(lazyAST, AST) ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "--- Reparser ---\n";
+	Frertex::AST::AST reparsedAST = AST;
+	start                         = Clock::now();
+
+	auto reparse = parser.Reparse(reparsedAST, edited, retokenized, { .Offset = editOffset, .RemovedLength = 5, .InsertedLength = 11 }, retokenize);
+
+	end = Clock::now();
+	Frertex::AST::AST editedAST = parser.Parse(edited, editedTokens);
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Declarations reused: " << reparse.ReusedDeclarations << ", reparsed: " << reparse.ReparsedDeclarations << "\n";
+	std::cout << "Matches: " << (SameAST(reparsedAST, editedAST) ? "yes" : "no") << "\n";
+
+	// Editing a term in the middle of the expression chain replaces the whole chain declaration and keeps the one in front of it
+	std::string                            chainSource = "void A()\n{\n}\n" + chain;
+	std::vector<Frertex::Tokenizer::Token> chainSourceTokens;
+	Frertex::Tokenizer::Tokenize(chainSource.c_str(), chainSource.size(), chainSourceTokens);
+	Frertex::AST::AST reparsedChainAST = parser.Parse(chainSource, chainSourceTokens);
+
+	std::string chainTerm       = fmt::format(" {} {} ", c_ChainOps[(c_ChainTerms / 2) & 3], c_ChainTerms / 2);
+	std::size_t chainEditOffset = chainSource.find(chainTerm) + 3;
+	std::size_t chainEditLength = chainTerm.size() - 4;
+	std::string editedChain     = chainSource;
+	editedChain.replace(chainEditOffset, chainEditLength, "7");
+	std::vector<Frertex::Tokenizer::Token> retokenizedChain = chainSourceTokens;
+	auto                                   chainRetokenize  = Frertex::Tokenizer::Retokenize(editedChain.c_str(), editedChain.size(), retokenizedChain, { .Offset = chainEditOffset, .RemovedLength = chainEditLength, .InsertedLength = 1 });
+	start                                                   = Clock::now();
+
+	auto chainReparse = parser.Reparse(reparsedChainAST, editedChain, retokenizedChain, { .Offset = chainEditOffset, .RemovedLength = chainEditLength, .InsertedLength = 1 }, chainRetokenize);
+
+	end = Clock::now();
+	Frertex::AST::AST editedChainAST = parser.Parse(editedChain, retokenizedChain);
+	std::cout << "Chain time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Declarations reused: " << chainReparse.ReusedDeclarations << ", reparsed: " << chainReparse.ReparsedDeclarations << "\n";
+	std::cout << "Matches: " << (SameAST(reparsedChainAST, editedChainAST) ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "-- Type index --\n";
+	start = Clock::now();
+
+	// The walker recurses once per sibling, so each top level declaration gets its own walk
+	std::size_t walkedDeclarations = 0;
+	for (std::uint64_t declaration = AST[AST.RootNode()].Child; declaration != ~0ULL; declaration = AST[declaration].NextSibling)
+	{
+		Frertex::AST::WalkASTNode(
+			AST,
+			declaration,
+			[&]([[maybe_unused]] const Frertex::AST::AST& ast, [[maybe_unused]] std::uint64_t index, const Frertex::AST::Node& node) -> Frertex::AST::EWalkerResult {
+				if (node.Type == Frertex::AST::EType::FunctionDeclaration)
+					++walkedDeclarations;
+				return Frertex::AST::EWalkerResult::Continue;
+			});
+	}
+
+	end           = Clock::now();
+	auto walkTime = end - start;
+	start         = Clock::now();
+
+	std::size_t indexedDeclarations = AST.NodesOfType(Frertex::AST::EType::FunctionDeclaration).size();
+
+	end            = Clock::now();
+	auto buildTime = end - start;
+	start          = Clock::now();
+
+	indexedDeclarations = AST.NodesOfType(Frertex::AST::EType::FunctionDeclaration).size();
+
+	end = Clock::now();
+	std::cout << "Walk time:          " << PrettyDuration(walkTime) << "\n";
+	std::cout << "Build time:         " << PrettyDuration(buildTime) << "\n";
+	std::cout << "Query time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Matches: " << (walkedDeclarations == indexedDeclarations ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "- Typed visitor -\n";
+	std::size_t walkedLiterals = 0;
+	start                      = Clock::now();
+	for (std::uint64_t declaration = AST[AST.RootNode()].Child; declaration != ~0ULL; declaration = AST[declaration].NextSibling)
+	{
+		Frertex::AST::WalkASTNode(
+			AST,
+			declaration,
+			[&]([[maybe_unused]] const Frertex::AST::AST& ast, [[maybe_unused]] std::uint64_t index, const Frertex::AST::Node& node) -> Frertex::AST::EWalkerResult {
+				switch (node.Type)
+				{
+				case Frertex::AST::EType::IntegerLiteral:
+				case Frertex::AST::EType::FloatLiteral:
+				case Frertex::AST::EType::BoolLiteral:
+					++walkedLiterals;
+					return Frertex::AST::EWalkerResult::Continue;
+				default:
+					return Frertex::AST::EWalkerResult::Continue;
+				}
+			});
+	}
+	end                  = Clock::now();
+	auto walkLiteralTime = end - start;
+
+	std::size_t visitedLiterals = 0;
+	auto        countLiteral    = [&]([[maybe_unused]] const Frertex::AST::AST& ast, [[maybe_unused]] std::uint64_t index, [[maybe_unused]] const Frertex::AST::Node& node) -> Frertex::AST::EWalkerResult {
+		++visitedLiterals;
+		return Frertex::AST::EWalkerResult::Continue;
+	};
+	std::size_t visitedDeclarations = 0;
+	start                           = Clock::now();
+	Frertex::AST::TypedVisitor declarationVisitor {
+		Frertex::AST::On<Frertex::AST::EType::FunctionDeclaration>([&]([[maybe_unused]] const Frertex::AST::AST& ast, [[maybe_unused]] std::uint64_t index, [[maybe_unused]] const Frertex::AST::Node& node) -> Frertex::AST::EWalkerResult {
+			++visitedDeclarations;
+			return Frertex::AST::EWalkerResult::Continue;
+		})
+	};
+	declarationVisitor.Walk(AST, AST.RootNode());
+	end                       = Clock::now();
+	auto visitDeclarationTime = end - start;
+	start                     = Clock::now();
+	Frertex::AST::TypedVisitor literalVisitor {
+		Frertex::AST::On<Frertex::AST::EType::IntegerLiteral>(countLiteral),
+		Frertex::AST::On<Frertex::AST::EType::FloatLiteral>(countLiteral),
+		Frertex::AST::On<Frertex::AST::EType::BoolLiteral>(countLiteral)
+	};
+	literalVisitor.Walk(AST, AST.RootNode());
+	end = Clock::now();
+	std::cout << "Declarations, lambda walker: " << PrettyDuration(walkTime) << "\n";
+	std::cout << "Declarations, typed visitor: " << PrettyDuration(visitDeclarationTime) << "\n";
+	std::cout << "Literals, lambda walker:     " << PrettyDuration(walkLiteralTime) << "\n";
+	std::cout << "Literals, typed visitor:     " << PrettyDuration(end - start) << "\n";
+
+	// The visitor skips subtrees by the table of direct child types, every parent and child pair the parser produces has to be in it.
+	// The input above only has a few constructs, this one has every one of them and is parsed with and without lazy bodies.
+	const std::string childTypeTest = R"([[VertexShader]]
+void Outer([[Position]] in float4 a, inout int b, out float c, Lib::Color e)
+{
+	;
+	{
+		b = -b + (1 << 2) * 0x10;
+	}
+	void Inner([[Flat(1, 2)]] int d)
+	{
+		Inner(!true && false, 1.5, d);
+	}
+	c = ~b;
+}
+)";
+	std::array<Frertex::AST::TypeMask, Frertex::AST::c_TypeCount> seenChildTypes {};
+
+	auto addChildTypes = [&](const Frertex::AST::AST& ast) {
+		for (std::size_t type = 0; type < Frertex::AST::c_TypeCount; ++type)
+			for (auto node : ast.NodesOfType(static_cast<Frertex::AST::EType>(type)))
+				for (std::uint64_t child = ast[node].Child; child != ~0ULL; child = ast[child].NextSibling)
+					seenChildTypes[type] |= Frertex::AST::TypeBit(ast[child].Type);
+	};
+	std::vector<Frertex::Tokenizer::Token> childTypeTokens;
+	Frertex::Parser::State                 childTypeParser;
+	Frertex::Tokenizer::Tokenize(childTypeTest.c_str(), childTypeTest.size(), childTypeTokens);
+	addChildTypes(AST);
+	addChildTypes(childTypeParser.Parse(childTypeTest, childTypeTokens));
+	addChildTypes(childTypeParser.Parse(childTypeTest, childTypeTokens, { .LazyFunctionBodies = true }));
+	std::size_t seenChildPairs    = 0;
+	std::size_t missingChildPairs = 0;
+	for (std::size_t type = 0; type < Frertex::AST::c_TypeCount; ++type)
+	{
+		Frertex::AST::TypeMask missing  = seenChildTypes[type] & ~Frertex::AST::Details::DirectChildTypes(static_cast<Frertex::AST::EType>(type));
+		seenChildPairs                  += std::popcount(seenChildTypes[type]);
+		missingChildPairs               += std::popcount(missing);
+		for (; missing; missing &= missing - 1)
+			std::cout << "Not in the child table: " << Frertex::AST::TypeToString(static_cast<Frertex::AST::EType>(type)) << " -> " << Frertex::AST::TypeToString(static_cast<Frertex::AST::EType>(std::countr_zero(missing))) << "\n";
+	}
+	std::cout << "Child type pairs:   " << seenChildPairs << " seen, " << missingChildPairs << " not in the table\n";
+	std::cout << "Matches: " << (visitedDeclarations == walkedDeclarations && visitedLiterals == walkedLiterals && missingChildPairs == 0 ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "- Subtree hash -\n";
+	start = Clock::now();
+
+	Frertex::AST::SubtreeHashes hashes;
+	hashes.Compute(AST, test, tokens);
+
+	end = Clock::now();
+	std::size_t uniqueDeclarations = 0;
+	std::size_t uniqueBodies       = 0;
+	auto        declarations       = AST.NodesOfType(Frertex::AST::EType::FunctionDeclaration);
+	auto        bodies             = AST.NodesOfType(Frertex::AST::EType::CompoundStatement);
+	for (auto node : declarations)
+		uniqueDeclarations += hashes.CanonicalOf(node) == node;
+	for (auto node : bodies)
+		uniqueBodies += hashes.CanonicalOf(node) == node;
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
 	std::cout << "Avg time per node:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / AST.Size()) << "\n";
+	std::cout << "Unique subtrees: " << hashes.UniqueCount() << "\n";
+	std::cout << "Unique functions: " << uniqueDeclarations << " of " << declarations.size() << "\n";
+	std::cout << "Unique bodies: " << uniqueBodies << " of " << bodies.size() << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "---- Dumper ----\n";
+	Frertex::AST::Dumper textDumper;
+	Frertex::AST::Dumper binaryDumper;
+	start = Clock::now();
+
+	textDumper.DumpAST(AST, AST.RootNode(), test);
+
+	end               = Clock::now();
+	auto coldDumpTime = end - start;
+	textDumper.Clear();
+	start = Clock::now();
+
+	textDumper.DumpAST(AST, AST.RootNode(), test);
+
+	end               = Clock::now();
+	auto textDumpTime = end - start;
+	auto textDumpSize = textDumper.Output().size();
+	auto textDumpHash = Frertex::Utils::HashString(textDumper.Output());
+	start             = Clock::now();
+
+	binaryDumper.DumpAST(AST, AST.RootNode(), test, Frertex::AST::EDumpFormat::Binary);
+
+	end = Clock::now();
+	textDumper.Clear();
+	auto binaryDump = binaryDumper.Output();
+	bool astMatches = textDumper.BinaryToText({ reinterpret_cast<const std::uint8_t*>(binaryDump.data()), reinterpret_cast<const std::uint8_t*>(binaryDump.data() + binaryDump.size()) }, test) &&
+					  Frertex::Utils::HashString(textDumper.Output()) == textDumpHash;
+	std::cout << "AST text time:      " << PrettyDuration(textDumpTime) << " (" << textDumpSize << " bytes)\n";
+	std::cout << "New buffer time:    " << PrettyDuration(coldDumpTime) << "\n";
+	std::cout << "AST binary time:    " << PrettyDuration(end - start) << " (" << binaryDump.size() << " bytes)\n";
+	std::cout << "Avg time per node:  " << PrettyDuration(std::chrono::duration_cast<Duration>(textDumpTime) / AST.Size()) << "\n";
+
+	textDumper.Clear();
+	binaryDumper.Clear();
+	start = Clock::now();
+
+	textDumper.DumpTokens(tokens, test);
+
+	end          = Clock::now();
+	textDumpTime = end - start;
+	textDumpSize = textDumper.Output().size();
+	textDumpHash = Frertex::Utils::HashString(textDumper.Output());
+	start        = Clock::now();
+
+	binaryDumper.DumpTokens(tokens, test, Frertex::AST::EDumpFormat::Binary);
+
+	end = Clock::now();
+	textDumper.Clear();
+	binaryDump        = binaryDumper.Output();
+	bool tokenMatches = textDumper.BinaryToText({ reinterpret_cast<const std::uint8_t*>(binaryDump.data()), reinterpret_cast<const std::uint8_t*>(binaryDump.data() + binaryDump.size()) }, test) &&
+						Frertex::Utils::HashString(textDumper.Output()) == textDumpHash;
+	std::cout << "Token text time:    " << PrettyDuration(textDumpTime) << " (" << textDumpSize << " bytes)\n";
+	std::cout << "Token binary time:  " << PrettyDuration(end - start) << " (" << binaryDump.size() << " bytes)\n";
+
+	// Dumps accumulate in Output(), so the AST dump followed by the token dump converts back to both texts in turn
+	textDumper.Clear();
+	textDumper.DumpAST(AST, AST.RootNode(), test);
+	textDumper.DumpTokens(tokens, test);
+	textDumpHash = Frertex::Utils::HashString(textDumper.Output());
+	binaryDumper.Clear();
+	binaryDumper.DumpAST(AST, AST.RootNode(), test, Frertex::AST::EDumpFormat::Binary);
+	binaryDumper.DumpTokens(tokens, test, Frertex::AST::EDumpFormat::Binary);
+	textDumper.Clear();
+	binaryDump       = binaryDumper.Output();
+	bool bothMatches = textDumper.BinaryToText({ reinterpret_cast<const std::uint8_t*>(binaryDump.data()), reinterpret_cast<const std::uint8_t*>(binaryDump.data() + binaryDump.size()) }, test) &&
+					   Frertex::Utils::HashString(textDumper.Output()) == textDumpHash;
+	std::cout << "Both dumps:         " << binaryDump.size() << " bytes\n";
+	std::cout << "Matches: " << (astMatches && tokenMatches && bothMatches ? "yes" : "no") << "\n";
+	std::cout << "----------------\n";
+
+	std::cout << "--- Compiler ---\n";
+	std::vector<Frertex::Tokenizer::Token> codegenTokens;
+	Frertex::Tokenizer::Tokenize(codegenTest.c_str(), codegenTest.size(), codegenTokens);
+	Frertex::AST::AST codegenAST = parser.Parse(codegenTest, codegenTokens);
+
+	std::uint64_t compileAllocations = AllocationCounter::Allocations();
+	start                            = Clock::now();
+
+	Frertex::Compiler::State compiler;
+	compiler.SetAllocationCounter(&AllocationCounter::ThreadAllocatedBytes);
+	Frertex::FIL::Binary FIL = compiler.Compile(codegenTest, codegenAST);
+
+	end                = Clock::now();
+	compileAllocations = AllocationCounter::Allocations() - compileAllocations;
+	std::cout << "Total time:         " << PrettyDuration(end - start) << "\n";
+	std::cout << "Avg time per char:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / codegenTest.size()) << "\n";
+	std::cout << "Avg time per node:  " << PrettyDuration(std::chrono::duration_cast<Duration>(end - start) / codegenAST.Size()) << "\n";
+	std::cout << "Allocations: " << compileAllocations << " for " << compiler.FunctionDeclarationCount() << " functions\n";
+	std::cout << "Symbols: " << compiler.Symbols().SymbolCount() << ", scopes: " << compiler.Symbols().ScopeCount() << ", types: " << FIL.Types.size() << ", constants: " << FIL.Constants.size() << "\n";
+	std::size_t instructionCount = 0;
+	std::size_t blockCount       = 0;
+	for (std::size_t i = 0; i < compiler.ModuleCount(); ++i)
+	{
+		instructionCount += compiler.Module(i).InstructionCount();
+		blockCount       += compiler.Module(i).BlockCount();
+	}
+	std::cout << "IR: " << instructionCount << " instructions in " << blockCount << " blocks over " << compiler.ModuleCount() << " workers, " << FIL.Code.size() << " code words\n";
+	for (auto& pass : compiler.Stats().Passes)
+		std::cout << fmt::format("  {:<14} wave {} {} {:>10} items {:>10} bytes\n", pass.Name, pass.Wave, PrettyDuration(std::chrono::nanoseconds(pass.Nanoseconds)), pass.Items, pass.AllocatedBytes);
+
+	std::string_view fragmentOnly[] { "Frag" };
+	start                         = Clock::now();
+	Frertex::FIL::Binary fragment = compiler.Compile(codegenTest, codegenAST, { .Entrypoints = fragmentOnly });
+	end                           = Clock::now();
+	std::cout << "Only Frag:          " << PrettyDuration(end - start) << " (" << fragment.Functions.size() << " functions, " << fragment.Entrypoints.size() << " entrypoints)\n";
+
+	// Output has to be the same whatever the number of codegen threads
+	std::vector<std::uint8_t> serialBytes;
+	std::vector<std::uint8_t> parallelBytes;
+	compiler.SetCodegenThreads(1);
+	Frertex::FIL::WriteBinary(compiler.Compile(codegenTest, codegenAST), serialBytes);
+	compiler.SetCodegenThreads(4);
+	start                         = Clock::now();
+	Frertex::FIL::Binary parallel = compiler.Compile(codegenTest, codegenAST);
+	end                           = Clock::now();
+	Frertex::FIL::WriteBinary(parallel, parallelBytes);
+	std::cout << "4 codegen threads:  " << PrettyDuration(end - start) << " (" << compiler.ModuleCount() << " workers)\n";
+	std::cout << "Matches: " << (serialBytes == parallelBytes ? "yes" : "no") << "\n";
+	compiler.SetCodegenThreads(0);
+
+	// Passes of a wave touch disjoint parts of the state, running them at the same time has to give the same output
+	compiler.SetParallelPasses(true);
+	start    = Clock::now();
+	parallel = compiler.Compile(codegenTest, codegenAST);
+	end      = Clock::now();
+	parallelBytes.clear();
+	Frertex::FIL::WriteBinary(parallel, parallelBytes);
+	std::cout << "Parallel passes:    " << PrettyDuration(end - start) << " (" << compiler.Stats().Passes.size() << " passes in " << compiler.Stats().Passes.back().Wave + 1 << " waves)\n";
+	std::cout << "Matches: " << (serialBytes == parallelBytes ? "yes" : "no") << "\n";
+	compiler.SetParallelPasses(false);
 	std::cout << "--------------\n";
+
+	std::cout << "- Steady state -\n";
+	std::vector<Frertex::Tokenizer::Token> unitTokens;
+	Frertex::AST::AST                      unitAST;
+	Frertex::FIL::Binary                   unitFIL;
+	std::uint64_t                          freshAllocations  = 0;
+	std::uint64_t                          reusedAllocations = 0;
+	for (std::size_t i = 0; i < 8; ++i)
+	{
+		std::uint64_t allocations = AllocationCounter::Allocations();
+		unitTokens.clear();
+		Frertex::Tokenizer::Tokenize(unit.c_str(), unit.size(), unitTokens);
+		Frertex::AST::AST freshAST = parser.Parse(unit, unitTokens);
+		compiler.Compile(unit, freshAST);
+		freshAllocations = AllocationCounter::Allocations() - allocations;
+
+		allocations = AllocationCounter::Allocations();
+		unitTokens.clear();
+		Frertex::Tokenizer::Tokenize(unit.c_str(), unit.size(), unitTokens);
+		parser.Parse(unitAST, unit, unitTokens);
+		compiler.Compile(unitFIL, unit, unitAST);
+		reusedAllocations = AllocationCounter::Allocations() - allocations;
+	}
+	std::cout << "Allocations per compile, fresh AST:  " << freshAllocations << "\n";
+	std::cout << "Allocations per compile, reused AST: " << reusedAllocations << "\n";
+	std::cout << "--------------\n";
+
+	std::cout << "---- Cache -----\n";
+	Frertex::Cache::DiskCache cache(std::filesystem::temp_directory_path() / "FrertexCLICache", 256ULL << 20);
+	std::filesystem::remove_all(cache.Directory());
+	std::vector<std::uint8_t> expectedBytes;
+	Frertex::FIL::WriteBinary(FIL, expectedBytes);
+
+	start                             = Clock::now();
+	Frertex::Cache::MappedFile missed = cache.Compile(codegenTest, {}, parser, compiler);
+	end                               = Clock::now();
+	auto missTime                     = end - start;
+
+	start                          = Clock::now();
+	Frertex::Cache::MappedFile hit = cache.Compile(codegenTest, {}, parser, compiler);
+	end                            = Clock::now();
+	std::cout << "Miss time:          " << PrettyDuration(missTime) << "\n";
+	std::cout << "Hit time:           " << PrettyDuration(end - start) << " (" << hit.Data().size() << " bytes mapped)\n";
+	std::cout << "Hits: " << cache.Hits() << ", misses: " << cache.Misses() << "\n";
+	std::cout << "Matches: " << (missed.Valid() && hit.Valid() && std::equal(hit.Data().begin(), hit.Data().end(), expectedBytes.begin(), expectedBytes.end()) ? "yes" : "no") << "\n";
+	missed = {};
+	hit    = {};
+	std::filesystem::remove_all(cache.Directory());
+	std::cout << "----------------\n";
 }
\ No newline at end of file
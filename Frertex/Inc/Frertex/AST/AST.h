@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <array>
 #include <concepts>
 #include <string_view>
 #include <vector>
@@ -22,6 +23,12 @@ namespace Frertex::AST
 		Statements,
 		EmptyStatement,
 		CompoundStatement,
+		LazyCompoundStatement,
+		ExpressionStatement,
+
+		BinaryExpression,
+		UnaryExpression,
+		CallExpression,
 
 		Parameters,
 		Parameter,
@@ -41,13 +48,55 @@ namespace Frertex::AST
 		Symbol
 	};
 
+	static constexpr std::size_t c_TypeCount = static_cast<std::size_t>(EType::Symbol) + 1;
+
 	std::string_view TypeToString(EType type);
 
+	enum class EOperator : std::uint8_t
+	{
+		None = 0,
+
+		Assign,
+		LogicalOr,
+		LogicalAnd,
+		BitOr,
+		BitXor,
+		BitAnd,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		ShiftLeft,
+		ShiftRight,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Remainder,
+
+		Negate,
+		Plus,
+		LogicalNot,
+		BitNot
+	};
+
+	std::string_view OperatorToString(EOperator op);
+
+	struct TokenRange
+	{
+	public:
+		std::uint64_t First = 0;
+		std::uint64_t Count = 0;
+	};
+
 	struct Node
 	{
 	public:
 		EType            Type;
-		std::uint16_t    Pad[3]          = { 0, 0, 0 };
+		std::uint16_t    Pad             = 0;
+		std::uint32_t    Value           = ~0U; // Literal nodes: index into the literal table, or the value of a BoolLiteral. FunctionDeclaration and LazyCompoundStatement: index into the token range table. BinaryExpression and UnaryExpression: the EOperator
 		Tokenizer::Token Token           = {};
 		std::uint64_t    Parent          = ~0ULL;
 		std::uint64_t    Child           = ~0ULL;
@@ -60,6 +109,9 @@ namespace Frertex::AST
 	public:
 		AST();
 
+		// Frees every node but keeps the node storage and value tables allocated for reuse
+		void Clear();
+
 		std::uint64_t GetChild(std::uint64_t node, std::uint64_t index) const;
 
 		std::uint64_t RootNode() const { return m_RootNode; }
@@ -70,6 +122,7 @@ namespace Frertex::AST
 		void          Free(std::uint64_t node);
 		void          FreeFull(std::uint64_t node, bool freeSiblings = false);
 
+		// Both keep Parent on every sibling, linking a sibling passes on the parent of the node it follows
 		void SetParent(std::uint64_t child, std::uint64_t parent);
 		void SetSiblings(std::uint64_t first, std::uint64_t second);
 
@@ -82,12 +135,40 @@ namespace Frertex::AST
 
 		std::uint64_t Size() const { return m_Size; }
 
+		// Every allocated node of 'type' in index order. The lists for all types are built in one pass over the node storage by the first query after the tree changed, so query before sharing the AST between threads
+		Utils::View<std::uint64_t> NodesOfType(EType type) const;
+		// Node types have to be changed through this to stay in the index
+		void                       SetType(std::uint64_t node, EType type);
+
+		std::uint32_t AddInteger(std::uint64_t value);
+		std::uint32_t AddFloat(double value);
+
+		std::uint64_t IntegerValue(std::uint64_t node) const;
+		double        FloatValue(std::uint64_t node) const;
+		bool          BoolValue(std::uint64_t node) const;
+		EOperator     Operator(std::uint64_t node) const;
+
+		std::uint32_t AddTokenRange(TokenRange range);
+		void          SetTokenRange(std::uint64_t node, TokenRange range);
+		TokenRange    TokenRangeOf(std::uint64_t node) const;
+
+	private:
+		void SetParents(std::uint64_t first, std::uint64_t parent);
+
 	private:
 		std::vector<Node>          m_Nodes;
 		std::vector<std::uint64_t> m_AllocationMap;
 		std::uint64_t              m_PreviousAllocation;
 		std::uint64_t              m_Size;
 
+		std::vector<std::uint64_t> m_Integers;
+		std::vector<double>        m_Floats;
+		std::vector<TokenRange>    m_TokenRanges;
+		std::vector<std::uint64_t> m_FreeList; // Worklist of FreeFull, kept for reuse
+
+		mutable std::array<std::vector<std::uint64_t>, c_TypeCount> m_TypeIndex;
+		mutable bool                                                m_TypeIndexDirty;
+
 		std::uint64_t m_RootNode;
 	};
 
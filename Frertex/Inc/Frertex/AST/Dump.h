@@ -0,0 +1,69 @@
+#pragma once
+
+#include "AST.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace Frertex::AST
+{
+	enum class EDumpFormat : std::uint8_t
+	{
+		Text,
+		Binary
+	};
+
+	// Text dumps have one line per node or token, nodes are indented two spaces per depth:
+	//   Type(start -> end): 'escaped source' [value of literal and operator nodes]
+	// Binary dumps start with a 4 byte magic ("FAST" or "FTOK") and a version byte, all numbers after that are LEB128:
+	//   Nodes:  one record per node in pre-order until a 0x7F byte in place of the type, so a dump can be streamed out before the node count is known.
+	//           Type, depth, zigzag start delta from the previous record, length, then the value for literal and operator nodes (floats as 8 raw little endian bytes)
+	//   Tokens: the token count, then per token the class, zigzag start delta from the previous record and length
+	// Binary dumps leave out the source text, BinaryToText puts it back given the same source.
+	class Dumper
+	{
+	public:
+		// With a file the buffer is written out whenever it grows past 'flushSize' and at the end of every dump, without one the dumps accumulate in Output()
+		Dumper(std::FILE* file = nullptr, std::size_t flushSize = 1 << 20);
+
+		void SetFile(std::FILE* file) { m_File = file; }
+
+		void DumpAST(const AST& ast, std::uint64_t node, std::string_view source, EDumpFormat format = EDumpFormat::Text);
+		void DumpTokens(Utils::View<Tokenizer::Token> tokens, std::string_view source, EDumpFormat format = EDumpFormat::Text);
+
+		// Appends the text form of one binary dump or several back to back as Output() holds them, returns false if any of them is malformed
+		bool BinaryToText(Utils::View<std::uint8_t> dump, std::string_view source);
+
+		std::string_view Output() const { return { m_Buffer.data(), m_Buffer.size() }; }
+
+		// Keeps the buffer capacity for the next dump
+		void Clear() { m_Buffer.clear(); }
+		void Flush();
+
+	private:
+		void WriteNodeText(std::size_t depth, EType type, Tokenizer::Token token, std::uint64_t value, std::string_view source);
+		void WriteNodeBinary(std::size_t depth, EType type, Tokenizer::Token token, std::uint64_t value, std::uint64_t& previousStart);
+		void WriteTokenText(Tokenizer::Token token, std::string_view source);
+		void WriteEscaped(std::string_view text);
+
+		void WriteU8(std::uint8_t value) { m_Buffer.push_back(static_cast<char>(value)); }
+		void WriteVarU64(std::uint64_t value);
+		void WriteVarI64(std::int64_t value);
+
+		void MaybeFlush()
+		{
+			if (m_File && m_Buffer.size() >= m_FlushSize)
+				Flush();
+		}
+
+	private:
+		fmt::memory_buffer m_Buffer;
+		std::FILE*         m_File;
+		std::size_t        m_FlushSize;
+	};
+} // namespace Frertex::AST
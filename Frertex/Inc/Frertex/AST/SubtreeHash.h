@@ -0,0 +1,39 @@
+#pragma once
+
+#include "AST.h"
+
+#include <cstdint>
+
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Frertex::AST
+{
+	// Merkle hashes of every subtree reachable from the root, built from node types, token text and child hashes.
+	// Equal subtrees hash equal wherever they are in the source, collisions are not checked.
+	// Equal hashes only mean equal text, nothing about parameter types, qualifiers or what names resolve to goes in, so two bodies with the same hash may still compile differently.
+	// Identical compiled functions are shared by comparing their emitted code instead, see Compiler::State::EmitFunctions.
+	class SubtreeHashes
+	{
+	public:
+		// 'tokens' has to be the tokens 'ast' was parsed from, unexpanded LazyCompoundStatements hash their tokens and are unique without them
+		void Compute(const AST& ast, std::string_view source, Utils::View<Tokenizer::Token> tokens = {});
+
+		std::uint64_t HashOf(std::uint64_t node) const { return node < m_Hashes.size() ? m_Hashes[node] : 0; }
+
+		// The first node in source order with 'hash', ~0ULL if there is none. It has the same text, not necessarily the same meaning.
+		std::uint64_t CanonicalNode(std::uint64_t hash) const;
+
+		std::uint64_t CanonicalOf(std::uint64_t node) const { return CanonicalNode(HashOf(node)); }
+
+		std::size_t UniqueCount() const { return m_Canonical.size(); }
+
+	private:
+		void HashNode(const AST& ast, std::uint64_t node, std::string_view source, Utils::View<Tokenizer::Token> tokens);
+
+	private:
+		std::vector<std::uint64_t>                       m_Hashes;
+		std::unordered_map<std::uint64_t, std::uint64_t> m_Canonical;
+	};
+} // namespace Frertex::AST
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "Frertex/AST/AST.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <bit>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Frertex::AST
+{
+	using TypeMask = std::uint64_t;
+
+	static_assert(c_TypeCount <= 64, "TypeMask needs a bit per node type");
+
+	constexpr TypeMask TypeBit(EType type) { return TypeMask { 1 } << static_cast<std::size_t>(type); }
+
+	template <class... Types>
+	constexpr TypeMask TypeBits(Types... types)
+	{
+		return (TypeMask { 0 } | ... | TypeBit(types));
+	}
+
+	static constexpr TypeMask c_AllTypes = c_TypeCount == 64 ? ~TypeMask { 0 } : (TypeMask { 1 } << c_TypeCount) - 1;
+
+	namespace Details
+	{
+		// Node types the parser puts directly below a node of 'type', has to be kept in sync with the parser
+		constexpr TypeMask DirectChildTypes(EType type)
+		{
+			constexpr TypeMask expression = TypeBits(EType::BinaryExpression,
+													 EType::UnaryExpression,
+													 EType::CallExpression,
+													 EType::IntegerLiteral,
+													 EType::FloatLiteral,
+													 EType::BoolLiteral,
+													 EType::Identifier);
+
+			switch (type)
+			{
+			case EType::Declarations: return TypeBit(EType::FunctionDeclaration);
+			case EType::FunctionDeclaration: return TypeBits(EType::Attributes, EType::Typename, EType::Identifier, EType::Parameters, EType::CompoundStatement, EType::LazyCompoundStatement);
+			case EType::Statements: return TypeBits(EType::EmptyStatement, EType::CompoundStatement, EType::ExpressionStatement, EType::FunctionDeclaration);
+			case EType::EmptyStatement: return 0;
+			case EType::CompoundStatement: return TypeBit(EType::Statements);
+			case EType::LazyCompoundStatement: return 0; // Expanding turns it into a CompoundStatement
+			case EType::ExpressionStatement: return expression;
+			case EType::BinaryExpression: return expression;
+			case EType::UnaryExpression: return expression;
+			case EType::CallExpression: return expression | TypeBit(EType::Arguments);
+			case EType::Parameters: return TypeBit(EType::Parameter);
+			case EType::Parameter: return TypeBits(EType::Attributes, EType::TypeQualifier, EType::Typename, EType::Identifier);
+			case EType::Arguments: return TypeBit(EType::Argument);
+			case EType::Argument: return expression;
+			case EType::Attributes: return TypeBit(EType::Attribute);
+			case EType::Attribute: return TypeBits(EType::Identifier, EType::Arguments);
+			case EType::Typename: return TypeBits(EType::Symbol, EType::Identifier);
+			case EType::TypeQualifier: return 0;
+			case EType::IntegerLiteral: return 0;
+			case EType::FloatLiteral: return 0;
+			case EType::BoolLiteral: return 0;
+			case EType::Identifier: return 0;
+			case EType::Symbol: return 0;
+			default: return c_AllTypes;
+			}
+		}
+
+		constexpr std::array<TypeMask, c_TypeCount> BuildSubtreeTypes()
+		{
+			std::array<TypeMask, c_TypeCount> types {};
+			for (std::size_t i = 0; i < c_TypeCount; ++i)
+				types[i] = DirectChildTypes(static_cast<EType>(i));
+
+			bool changed = true;
+			while (changed)
+			{
+				changed = false;
+				for (std::size_t i = 0; i < c_TypeCount; ++i)
+				{
+					TypeMask closure = types[i];
+					for (std::size_t j = 0; j < c_TypeCount; ++j)
+						if (types[i] & (TypeMask { 1 } << j))
+							closure |= types[j];
+					if (closure != types[i])
+					{
+						types[i] = closure;
+						changed  = true;
+					}
+				}
+			}
+			return types;
+		}
+	} // namespace Details
+
+	// Every node type that can appear anywhere below a node of each type
+	static constexpr std::array<TypeMask, c_TypeCount> c_SubtreeTypes = Details::BuildSubtreeTypes();
+
+	namespace Details
+	{
+		constexpr TypeMask DescendTypes(TypeMask handledTypes)
+		{
+			TypeMask types = 0;
+			for (std::size_t i = 0; i < c_TypeCount; ++i)
+				if (c_SubtreeTypes[i] & handledTypes)
+					types |= TypeMask { 1 } << i;
+			return types;
+		}
+	} // namespace Details
+
+	template <EType Type, class F>
+	struct TypeHandler
+	{
+	public:
+		static constexpr EType c_Type = Type;
+
+		F Func;
+	};
+
+	template <EType Type, ConstWalkerVisiter F>
+	constexpr TypeHandler<Type, std::decay_t<F>> On(F&& func)
+	{
+		return { std::forward<F>(func) };
+	}
+
+	// Pre-order walker that only calls back for the node types it has handlers for, and only descends into subtrees that can contain one of them.
+	// Handlers return the same EWalkerResult as WalkASTNode enter callbacks, there are no exit callbacks.
+	// TypedVisitor visitor { On<EType::Identifier>([&](const AST& ast, std::uint64_t index, const Node& node) -> EWalkerResult { ... }) };
+	template <class... Handlers>
+	class TypedVisitor
+	{
+	public:
+		static constexpr TypeMask c_HandledTypes = TypeBits(Handlers::c_Type...);
+
+		static_assert(std::popcount(c_HandledTypes) == sizeof...(Handlers), "Only one handler per node type");
+
+		// Types whose subtrees can contain a handled type, every other subtree is skipped without being looked at
+		static constexpr TypeMask c_DescendTypes = Details::DescendTypes(c_HandledTypes);
+
+	public:
+		constexpr TypedVisitor(Handlers... handlers)
+			: m_Handlers(std::move(handlers)...) {}
+
+		void Walk(const AST& ast, std::uint64_t node)
+		{
+			static constexpr std::array<Thunk, c_TypeCount> c_Dispatch = BuildDispatch(std::index_sequence_for<Handlers...> {});
+
+			if (node == ~0ULL)
+				return;
+
+			m_SkipSiblingsOf.clear();
+			std::uint64_t current = node;
+			while (true)
+			{
+				const Node&   value  = ast[current];
+				TypeMask      bit    = TypeBit(value.Type);
+				EWalkerResult result = EWalkerResult::Continue;
+				if (c_HandledTypes & bit)
+				{
+					result = c_Dispatch[static_cast<std::size_t>(value.Type)](*this, ast, current, value);
+					if (result == EWalkerResult::Stop)
+						return;
+				}
+
+				if (result != EWalkerResult::SkipChild && (c_DescendTypes & bit) && value.Child != ~0ULL)
+				{
+					if (result == EWalkerResult::SkipSiblings)
+						m_SkipSiblingsOf.emplace_back(current);
+					current = value.Child;
+					continue;
+				}
+
+				bool skipSiblings = result == EWalkerResult::SkipSiblings;
+				while (true)
+				{
+					if (current == node)
+						return;
+
+					const Node& up = ast[current];
+					if (!skipSiblings && up.NextSibling != ~0ULL)
+					{
+						current = up.NextSibling;
+						break;
+					}
+					current      = up.Parent;
+					skipSiblings = !m_SkipSiblingsOf.empty() && m_SkipSiblingsOf.back() == current;
+					if (skipSiblings)
+						m_SkipSiblingsOf.pop_back();
+				}
+			}
+		}
+
+	private:
+		using Thunk = EWalkerResult (*)(TypedVisitor& self, const AST& ast, std::uint64_t index, const Node& node);
+
+		template <std::size_t I>
+		static EWalkerResult Call(TypedVisitor& self, const AST& ast, std::uint64_t index, const Node& node)
+		{
+			return std::get<I>(self.m_Handlers).Func(ast, index, node);
+		}
+
+		template <std::size_t... Is>
+		static constexpr std::array<Thunk, c_TypeCount> BuildDispatch(std::index_sequence<Is...>)
+		{
+			std::array<Thunk, c_TypeCount> dispatch {};
+			((dispatch[static_cast<std::size_t>(Handlers::c_Type)] = &Call<Is>), ...);
+			return dispatch;
+		}
+
+	private:
+		std::tuple<Handlers...> m_Handlers;
+
+		std::vector<std::uint64_t> m_SkipSiblingsOf; // Nodes that returned SkipSiblings and whose children are being walked
+	};
+
+	template <class... Handlers>
+	TypedVisitor(Handlers...) -> TypedVisitor<Handlers...>;
+} // namespace Frertex::AST
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Frertex/Compiler/Compiler.h"
+#include "Frertex/FIL/FIL.h"
+#include "Frertex/Parser/Parser.h"
+#include "Frertex/Utils/View.h"
+
+#include <atomic>
+#include <filesystem>
+#include <string_view>
+
+namespace Frertex::Cache
+{
+	// 128 bits of source, compiler version, FIL version and compile options
+	struct Key
+	{
+	public:
+		std::uint64_t Low;
+		std::uint64_t High;
+	};
+
+	Key MakeKey(std::string_view source, const Compiler::CompileOptions& options);
+
+	// A read only view of a whole file, unmapped on destruction
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile(MappedFile&& move) noexcept;
+		~MappedFile();
+
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&& move) noexcept;
+
+		// Empty when the file does not exist or could not be mapped
+		static MappedFile Map(const std::filesystem::path& path);
+
+		Utils::View<std::uint8_t> Data() const { return { m_Data, m_Data + m_Size }; }
+		bool                      Valid() const { return m_Data != nullptr; }
+
+	private:
+		const std::uint8_t* m_Data = nullptr;
+		std::size_t         m_Size = 0;
+	};
+
+	// Serialized FIL binaries in a directory, one file per Key named after it.
+	// Files are written under a temporary name and renamed into place, so readers never see a partial binary and need no locks, any number of processes may share the directory.
+	// Hits touch the modification time of their file and Trim removes the least recently used files until the directory fits the size cap.
+	class DiskCache
+	{
+	public:
+		DiskCache(std::filesystem::path directory, std::uint64_t maxBytes);
+
+		// Maps the binary stored for 'key', empty on a miss
+		MappedFile Find(const Key& key);
+		// Returns false if the binary could not be written, Trim keeps the directory under the cap afterwards
+		bool       Store(const Key& key, const FIL::Binary& binary);
+		void       Trim();
+
+		// Maps the cached binary, on a miss tokenizes, parses and compiles 'source' first and stores the result.
+		// Empty when the compiled binary could not be stored.
+		MappedFile Compile(std::string_view source, const Compiler::CompileOptions& options, Parser::State& parser, Compiler::State& compiler);
+
+		const std::filesystem::path& Directory() const { return m_Directory; }
+		std::uint64_t                Hits() const { return m_Hits.load(std::memory_order_relaxed); }
+		std::uint64_t                Misses() const { return m_Misses.load(std::memory_order_relaxed); }
+
+	private:
+		std::filesystem::path PathOf(const Key& key) const;
+
+	private:
+		std::filesystem::path m_Directory;
+		std::uint64_t         m_MaxBytes;
+
+		std::atomic<std::uint64_t> m_Hits   = 0;
+		std::atomic<std::uint64_t> m_Misses = 0;
+	};
+} // namespace Frertex::Cache
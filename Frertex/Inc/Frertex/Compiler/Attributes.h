@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Frertex/Compiler/ConstantTable.h"
+#include "Frertex/Utils/View.h"
+
+#include <cstdint>
+
+#include <string_view>
+
+namespace Frertex::Compiler
+{
+	class State;
+
+	enum class EAttributeTarget : std::uint8_t
+	{
+		None      = 0x00,
+		Function  = 0x01,
+		Parameter = 0x02
+	};
+
+	inline bool HasTarget(EAttributeTarget targets, EAttributeTarget target)
+	{
+		return (static_cast<std::uint8_t>(targets) & static_cast<std::uint8_t>(target)) != 0;
+	}
+
+	// What an attribute list is attached to
+	struct AttributeSubject
+	{
+	public:
+		EAttributeTarget Target;
+		std::uint32_t    Index; // Into the function declarations or parameters depending on Target
+	};
+
+	// One registered attribute, State::FindAttribute finds them by name through a generated perfect hash.
+	// Adding an attribute is a key in Generator/Run/Lookup/Lookups.txt and an entry in Src/Compiler/Attributes.cpp, the compiler itself never compares attribute names.
+	struct Attribute
+	{
+	public:
+		// Arguments are constant expressions, evaluated before the handler runs
+		using Handler = void (State::*)(const Attribute& attribute, std::uint64_t node, Utils::View<ConstantValue> arguments, AttributeSubject subject);
+
+	public:
+		std::string_view Name;
+		EAttributeTarget Targets; // Everything the attribute may be attached to, it is unused anywhere else
+		std::uint8_t     MinArguments;
+		std::uint8_t     MaxArguments;
+		Handler          Handle;
+		std::uint32_t    Value; // Handler specific, the EEntrypointType of entrypoint attributes
+	};
+} // namespace Frertex::Compiler
@@ -1,13 +1,22 @@
 #pragma once
 
 #include "Frertex/AST/AST.h"
+#include "Frertex/Compiler/Attributes.h"
+#include "Frertex/Compiler/ConstantTable.h"
+#include "Frertex/Compiler/PassManager.h"
+#include "Frertex/Compiler/SymbolTable.h"
+#include "Frertex/Compiler/TypeTable.h"
 #include "Frertex/FIL/FIL.h"
+#include "Frertex/IR/IR.h"
 
 #include <string>
 #include <vector>
 
 namespace Frertex::Compiler
 {
+	// Bumped whenever the same source and options compile to different FIL, cached binaries are keyed by it
+	static constexpr std::uint32_t c_Version = 4;
+
 	struct FunctionDeclaration
 	{
 	public:
@@ -15,26 +24,68 @@ namespace Frertex::Compiler
 		{
 		public:
 			FIL::ETypeQualifier Qualifier;
-			std::string         Type;
-			std::string         Identifier;
-			std::string         Location;
+			TypeID              Type;
+			SymbolID            Identifier;
+			SymbolID            Location; // c_InvalidID without a location attribute
 		};
 
 	public:
 		std::uint64_t Node;
 
 		FIL::EEntrypointType Type;
-		std::string          Identifier;
-		std::string          FullyQualifiedName;
+		ScopeID              Scope; // Enclosing functions act as namespaces
+		SymbolID             Identifier;
+		ScopeID              Body; // The scope of functions declared inside it
+
+		// Only resolved for functions that get compiled
+		TypeID        ReturnType;
+		std::uint32_t FirstParameter;
+		std::uint32_t ParameterCount;
 
-		std::string            ReturnType;
-		std::vector<Parameter> Parameters;
+		std::uint32_t Function;    // Index into the FIL functions, c_InvalidID when no compiled entrypoint reaches it
+		bool          Entrypoint;  // Compiled as an entrypoint, false for entrypoints CompileOptions::Entrypoints leaves out
+		std::uint32_t FirstCallee; // Into the call graph, see State::GetCallee
+		std::uint32_t CalleeCount;
+	};
+
+	struct CompileOptions
+	{
+	public:
+		// Qualified names of the entrypoints to compile, only functions they reach are analysed and emitted. Empty compiles everything.
+		Utils::View<std::string_view> Entrypoints;
 	};
 
 	class State
 	{
 	public:
-		FIL::Binary Compile(std::string_view source, const AST::AST& ast);
+		State();
+
+		FIL::Binary Compile(std::string_view source, const AST::AST& ast, CompileOptions options = {});
+		// Compiles into 'binary', reusing its storage
+		void        Compile(FIL::Binary& binary, std::string_view source, const AST::AST& ast, CompileOptions options = {});
+
+		// Per pass timing, allocations and item counts of the last compile
+		const CompileStats& Stats() const { return m_Stats; }
+		// Lets passes that do not depend on each other run on their own threads
+		void                SetParallelPasses(bool parallel) { m_Passes.SetParallel(parallel); }
+		void                SetAllocationCounter(AllocationCounter counter) { m_Passes.SetAllocationCounter(counter); }
+		// Threads lowering and emitting functions, 0 uses one per hardware thread. The binary is the same whatever the count.
+		void                SetCodegenThreads(std::uint32_t threads) { m_CodegenThreads = threads; }
+
+		const SymbolTable&   Symbols() const { return m_Symbols; }
+		const TypeTable&     Types() const { return m_Types; }
+		// Every constant the last binary references, in FIL constant order
+		const ConstantTable& Constants() const { return m_Constants; }
+		// One module per codegen worker, each holding a contiguous range of the compiled functions in order
+		std::size_t          ModuleCount() const { return m_WorkerCount; }
+		const IR::Module&    Module(std::size_t index) const { return m_Workers[index].IR; }
+
+		std::size_t                FunctionDeclarationCount() const { return m_FunctionDeclarations.size(); }
+		const FunctionDeclaration& GetFunctionDeclaration(std::size_t index) const { return m_FunctionDeclarations[index]; }
+
+		const FunctionDeclaration::Parameter& GetParameter(const FunctionDeclaration& declaration, std::size_t index) const { return m_Parameters[declaration.FirstParameter + index]; }
+		// Declaration index of a function called by 'declaration', the call graph only covers compiled functions and is only built when filtering entrypoints
+		std::uint32_t                         GetCallee(const FunctionDeclaration& declaration, std::size_t index) const { return m_Callees[declaration.FirstCallee + index]; }
 
 	private:
 		void ReportMessage(std::uint8_t messageType, Utils::View<std::uint64_t> nodes, std::uint64_t point, std::string_view message);
@@ -43,15 +94,140 @@ namespace Frertex::Compiler
 
 		std::string_view GetSource(const Tokenizer::Token& token);
 
-		void FindDeclarations();
+		// Passes return the number of items they worked through for CompileStats
+		std::uint64_t FindDeclarations();
+		// Numbers the functions to compile, walking the call graph from the selected entrypoints when filtering
+		std::uint64_t FindReachable();
+		// Resolves return and parameter types of the functions to compile
+		std::uint64_t ResolveSignatures();
+
+		TypeID GetType(std::uint64_t node);
+
+		// The registered attribute called 'name', nullptr if there is none
+		static const Attribute* FindAttribute(std::string_view name);
+
+		// Checks every attribute under the Attributes node 'attributes' against the registry and runs its handler
+		void ApplyAttributes(std::uint64_t attributes, AttributeSubject subject);
+		void OnEntrypointAttribute(const Attribute& attribute, std::uint64_t node, Utils::View<ConstantValue> arguments, AttributeSubject subject);
+		void OnLocationAttribute(const Attribute& attribute, std::uint64_t node, Utils::View<ConstantValue> arguments, AttributeSubject subject);
+
+		// Evaluates an expression of literals and operators on them, false if anything else is in it or an operation has no defined result
+		bool EvaluateConstant(std::uint64_t node, ConstantValue& result);
+
+		struct CodegenWorker;
+
+		// Runs 'work' for the first m_WorkerCount workers, all but the first on their own threads
+		void RunWorkers(void (State::*work)(CodegenWorker&));
+
+		// Splits the compiled functions between the workers and lowers each one into the IR of its worker in one pass over its body
+		std::uint64_t LowerFunctions();
+		void          LowerRange(CodegenWorker& worker);
+		void          LowerFunction(CodegenWorker& worker, std::uint32_t declaration);
+		IR::Ref       LowerExpression(CodegenWorker& worker, std::uint64_t node);
+		IR::Ref       LowerIdentifier(CodegenWorker& worker, std::uint64_t node);
+		IR::Ref       AddConstant(CodegenWorker& worker, TypeID type, std::uint64_t bits, std::uint64_t node);
 
-		std::string GetTypename(std::uint64_t node);
-		std::string GetLocation(std::string_view string);
+		// Replaces operations whose operands are all constants with their result and removes the constants nothing uses afterwards
+		std::uint64_t FoldConstants();
+		void          FoldRange(CodegenWorker& worker);
+		bool          ConstantOf(const CodegenWorker& worker, IR::Ref value, ConstantValue& result) const;
+		// Looks for 'name' from inside 'caller', c_InvalidID if it names no function
+		std::uint32_t FindFunction(std::uint32_t caller, std::string_view name) const;
+		std::uint32_t FindParameter(std::uint32_t caller, std::string_view name) const;
+
+		// Emits the FIL code, functions and entrypoints of every worker into its own buffers, then appends those in worker order.
+		// Functions with the same code and signature share one code range and identical names are stored once.
+		std::uint64_t EmitFunctions();
+		void          EmitRange(CodegenWorker& worker);
+		// Index of an earlier function in m_Binary with the same code and signature as 'function' or the same name, otherwise adds 'function' to the slots
+		std::uint32_t FindSameCode(std::uint32_t function, const std::uint32_t* code, std::uint64_t hash);
+		std::uint32_t FindSameName(std::uint32_t function, const std::uint8_t* name, std::uint64_t hash);
+		// Emits the type section with the names of Named types in m_TypeNames, which leaves the string table to EmitFunctions so both can run at the same time
+		std::uint64_t EmitTypes();
+		// Appends m_TypeNames to the string table behind the names of the functions and moves the name offsets of the types along
+		std::uint64_t LinkTypeNames();
 
 	private:
+		// One pending step of LowerExpression, nodes with children come back once their operands are lowered
+		struct LowerFrame
+		{
+		public:
+			std::uint64_t Node;
+			std::uint32_t Stage        = 0;
+			std::uint32_t Count        = 0; // Arguments of calls
+			IR::Ref       Value        = IR::c_NoRef;
+			IR::Ref       Branch       = IR::c_NoRef;
+			IR::Ref       Block        = IR::c_NoRef;
+			std::uint32_t SnapshotBase = 0;
+		};
+
+		// Everything lowering and emitting a range of functions writes to, so ranges can run on their own threads
+		struct CodegenWorker
+		{
+		public:
+			std::uint32_t FirstFunction   = 0; // Index into the FIL functions, see m_CompiledFunctions
+			std::uint32_t FunctionCount   = 0;
+			std::uint32_t FirstEntrypoint = 0;
+
+			IR::Module              IR; // Function i holds FIL function FirstFunction + i
+			std::uint32_t           CurrentFunction = 0;
+			std::vector<IR::Ref>    Variables; // The current value of every parameter of the function being lowered
+			std::vector<IR::Ref>    VariableSnapshots;
+			std::vector<LowerFrame> LowerFrames;
+			std::vector<IR::Ref>    Values;
+			ConstantTable           Constants;   // Of this worker, ConstantIDs maps them to m_Constants
+			std::vector<ConstantID> ConstantIDs; // c_InvalidID for constants nothing references
+			std::uint64_t           Folded         = 0;
+			std::uint64_t           AllocatedBytes = 0; // By the thread of the last RunWorkers, workers other than the first only
+
+			std::vector<std::uint32_t> CallOperands;
+			std::vector<std::uint32_t> Code;       // Offsets into it are made absolute when merging
+			std::vector<std::uint8_t>  Strings;
+			std::vector<std::uint64_t> CodeHashes; // Per function, of its code and signature
+			std::vector<std::uint64_t> NameHashes;
+			std::string                Name;
+		};
+
+		// Functions below this many per worker are not worth a thread
+		static constexpr std::uint32_t c_MinFunctionsPerWorker = 1024;
+
+	private:
+		PassManager  m_Passes;
+		CompileStats m_Stats;
+
 		std::string_view m_Source;
 		const AST::AST*  m_AST;
+		CompileOptions   m_Options;
+		FIL::Binary*     m_Binary = nullptr;
+
+		SymbolTable   m_Symbols;
+		TypeTable     m_Types;
+		ConstantTable m_Constants;
+
+		std::vector<FunctionDeclaration>            m_FunctionDeclarations;
+		std::vector<FunctionDeclaration::Parameter> m_Parameters;
+		std::vector<std::string_view>               m_NamespaceStack;
+		std::vector<std::uint64_t>                  m_DeclarationNodes; // Function declaration nodes in source order
+		std::vector<std::uint32_t>                  m_ScopeFunctions;   // Per ScopeID, the first function whose Body it is
+		std::vector<ConstantValue>                  m_AttributeArguments;
+		std::vector<LowerFrame>                     m_EvaluateFrames;
+		std::vector<ConstantValue>                  m_EvaluateValues;
+		std::vector<std::uint32_t>                  m_Callees;
+		std::vector<std::uint32_t>                  m_CompiledFunctions; // Declaration index of every FIL function
+		std::vector<std::uint32_t>                  m_Reached; // Functions whose callees are yet to be found
+		std::vector<bool>                           m_FoundEntrypoints;
+
+		TypeID m_BoolType  = TypeTable::c_Void;
+		TypeID m_IntType   = TypeTable::c_Void;
+		TypeID m_FloatType = TypeTable::c_Void;
 
-		std::vector<FunctionDeclaration> m_FunctionDeclarations;
+		// Workers past m_WorkerCount are idle but keep their storage for later compiles
+		std::vector<CodegenWorker> m_Workers;
+		std::size_t                m_WorkerCount    = 0;
+		std::uint32_t              m_CodegenThreads = 0;
+		std::string                m_Name;
+		std::vector<std::uint32_t> m_CodeSlots; // Open addressing over FIL function indices
+		std::vector<std::uint32_t> m_NameSlots;
+		std::vector<std::uint8_t>  m_TypeNames;
 	};
 } // namespace Frertex::Compiler
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Frertex/AST/AST.h"
+#include "Frertex/Compiler/TypeTable.h"
+#include "Frertex/FIL/FIL.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace Frertex::Compiler
+{
+	using ConstantID = std::uint32_t;
+
+	// A value before it has a TypeID, held at 64 bits like literals are parsed but always at the width of its class.
+	// Bools are 0 or 1, ints are 32 bit two's complement sign extended to 64 bits and floats are doubles rounded to single precision.
+	struct ConstantValue
+	{
+	public:
+		FIL::ETypeClass Class;
+		std::uint64_t   Bits;
+	};
+
+	struct Constant
+	{
+	public:
+		TypeID        Type;
+		std::uint64_t Bits;
+
+		friend bool operator==(const Constant& lhs, const Constant& rhs) = default;
+	};
+
+	// The opcode of an operator, Nop for operators that are not plain operations such as assignments and short circuiting ones
+	FIL::EOpcode UnaryOpcode(AST::EOperator op);
+	FIL::EOpcode BinaryOpcode(AST::EOperator op);
+
+	// Wraps ints to 32 bits and rounds floats to single precision, classes without folding support are returned as is
+	ConstantValue FitToClass(ConstantValue value);
+
+	// Evaluates 'opcode' at compile time at the width of the operand class, false if it does not apply to the operand classes or has no defined result.
+	// Integer division by zero, INT_MIN / -1 and shifts by 32 or more are left for run time, floats follow IEEE 754 so 1.0 / 0.0 folds to infinity.
+	bool FoldUnary(FIL::EOpcode opcode, ConstantValue operand, ConstantValue& result);
+	bool FoldBinary(FIL::EOpcode opcode, ConstantValue lhs, ConstantValue rhs, ConstantValue& result);
+
+	// Constants deduplicated by type and bit pattern, ConstantIDs count up from 0 in the order constants are first seen
+	class ConstantTable
+	{
+	public:
+		ConstantTable();
+
+		// Keeps all storage for the next compile
+		void Clear();
+
+		ConstantID Intern(const Constant& constant);
+
+		const Constant& operator[](ConstantID constant) const { return m_Constants[constant]; }
+
+		std::size_t Size() const { return m_Constants.size(); }
+
+		// Appends the FIL constant section
+		void Emit(FIL::Binary& binary) const;
+
+	private:
+		static std::uint64_t Hash(const Constant& constant);
+
+		void GrowSlots();
+
+	private:
+		std::vector<Constant>   m_Constants;
+		std::vector<ConstantID> m_Slots;
+	};
+} // namespace Frertex::Compiler
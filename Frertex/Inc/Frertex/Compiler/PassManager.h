@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string_view>
+#include <vector>
+
+namespace Frertex::Compiler
+{
+	class State;
+
+	// What a pass reads and writes, passes that do not write anything another one touches may run at the same time
+	enum class EPassResource : std::uint32_t
+	{
+		None         = 0x00,
+		AST          = 0x01,
+		Declarations = 0x02,
+		Symbols      = 0x04,
+		Types        = 0x08,
+		IR           = 0x10,
+		BinaryCode   = 0x20, // Functions, entrypoints, constants, code and strings of the binary
+		BinaryTypes  = 0x40  // Types of the binary and their names until those are linked into the strings
+	};
+
+	constexpr EPassResource operator|(EPassResource lhs, EPassResource rhs)
+	{
+		return static_cast<EPassResource>(static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs));
+	}
+
+	constexpr bool Overlaps(EPassResource lhs, EPassResource rhs)
+	{
+		return (static_cast<std::uint32_t>(lhs) & static_cast<std::uint32_t>(rhs)) != 0;
+	}
+
+	struct PassStats
+	{
+	public:
+		std::string_view Name;
+		std::uint32_t    Wave;           // Passes of the same wave ran concurrently when running in parallel
+		std::uint64_t    Nanoseconds;    // Wall time
+		std::uint64_t    AllocatedBytes; // Heap bytes allocated by the thread running the pass and the helper threads it reported, 0 without an allocation counter
+		std::uint64_t    Items;          // Whatever the pass works through, nodes, declarations, instructions or code words
+	};
+
+	struct CompileStats
+	{
+	public:
+		std::vector<PassStats> Passes;
+		std::uint64_t          Nanoseconds = 0; // Wall time of all passes, less than their sum when waves ran in parallel
+	};
+
+	// Bytes allocated so far by the calling thread, provided by whoever owns the allocator
+	using AllocationCounter = std::uint64_t (*)();
+
+	// Runs the passes of a compile in the order they were added and times each of them.
+	// Consecutive passes that do not conflict form a wave, with parallel runs enabled the passes of a wave run on their own threads.
+	class PassManager
+	{
+	public:
+		// Returns the number of items it worked through
+		using PassFunction = std::uint64_t (State::*)();
+
+	public:
+		void Add(std::string_view name, PassFunction function, EPassResource reads, EPassResource writes);
+
+		void              SetParallel(bool parallel) { m_Parallel = parallel; }
+		void              SetAllocationCounter(AllocationCounter counter) { m_AllocationCounter = counter; }
+		AllocationCounter GetAllocationCounter() const { return m_AllocationCounter; }
+
+		// Passes that spread their work over threads of their own measure those threads with the allocation counter and add the bytes here, from the thread running the pass
+		static void AddHelperAllocations(std::uint64_t bytes);
+
+		// Overwrites 'stats', its storage is reused
+		void Run(State& state, CompileStats& stats) const;
+
+		std::size_t PassCount() const { return m_Passes.size(); }
+		std::size_t WaveCount() const { return m_Passes.empty() ? 0 : m_Passes.back().Wave + 1; }
+
+	private:
+		struct Pass
+		{
+		public:
+			std::string_view Name;
+			PassFunction     Function;
+			EPassResource    Reads;
+			EPassResource    Writes;
+			std::uint32_t    Wave;
+		};
+
+		void RunPass(State& state, const Pass& pass, PassStats& stats) const;
+
+	private:
+		std::vector<Pass> m_Passes;
+		bool              m_Parallel          = false;
+		AllocationCounter m_AllocationCounter = nullptr;
+	};
+} // namespace Frertex::Compiler
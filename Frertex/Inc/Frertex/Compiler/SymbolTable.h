@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Frertex::Compiler
+{
+	using SymbolID = std::uint32_t;
+	using ScopeID  = std::uint32_t;
+
+	static constexpr std::uint32_t c_InvalidID = ~0U;
+
+	// Interned names and a tree of named scopes, both referred to by 32 bit IDs.
+	// Name characters live in one arena and both lookups are open addressing tables, so interning allocates only when storage grows, and Clear keeps all storage for the next compile.
+	class SymbolTable
+	{
+	public:
+		static constexpr ScopeID c_GlobalScope = 0;
+
+	public:
+		SymbolTable();
+
+		void Clear();
+
+		// The same name always gives the same ID until the next Clear
+		SymbolID         Intern(std::string_view name);
+		std::string_view NameOf(SymbolID symbol) const;
+		// c_InvalidID if 'name' was never interned
+		SymbolID         Find(std::string_view name) const;
+
+		// The child scope 'name' of 'parent', created the first time it is asked for
+		ScopeID  Scope(ScopeID parent, SymbolID name);
+		ScopeID  FindScope(ScopeID parent, SymbolID name) const;
+		ScopeID  ParentOf(ScopeID scope) const { return m_Scopes[scope].Parent; }
+		SymbolID ScopeName(ScopeID scope) const { return m_Scopes[scope].Name; }
+
+		// Appends 'Outer::Inner::name' to 'out', qualified names are only ever built here
+		void AppendQualifiedName(ScopeID scope, SymbolID name, std::string& out) const;
+
+		std::size_t SymbolCount() const { return m_Symbols.size(); }
+		std::size_t ScopeCount() const { return m_Scopes.size(); }
+
+	private:
+		struct Symbol
+		{
+		public:
+			std::uint32_t Offset;
+			std::uint32_t Length;
+			std::uint64_t Hash;
+		};
+
+		struct ScopeEntry
+		{
+		public:
+			ScopeID  Parent;
+			SymbolID Name;
+		};
+
+		static std::uint64_t ScopeHash(ScopeID parent, SymbolID name);
+
+		void GrowSymbolSlots();
+		void GrowScopeSlots();
+
+	private:
+		std::vector<char>     m_Characters;
+		std::vector<Symbol>   m_Symbols;
+		std::vector<SymbolID> m_SymbolSlots;
+
+		std::vector<ScopeEntry> m_Scopes;
+		std::vector<ScopeID>    m_ScopeSlots;
+	};
+} // namespace Frertex::Compiler
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Frertex/Compiler/SymbolTable.h"
+#include "Frertex/FIL/FIL.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Frertex::Compiler
+{
+	using TypeID = std::uint32_t;
+
+	struct Type
+	{
+	public:
+		FIL::ETypeClass Class;
+		std::uint8_t    Rows;
+		std::uint8_t    Columns;
+		ScopeID         Scope; // Named types only, the namespaces the name was qualified with
+		SymbolID        Name;  // Named types only
+
+		friend bool operator==(const Type& lhs, const Type& rhs) = default;
+	};
+
+	// Hash-consed types, every structurally distinct type is created once and equal types get equal TypeIDs.
+	// TypeIDs count up from 0 in the order types are first seen and are used as FIL TypeIDs as is.
+	class TypeTable
+	{
+	public:
+		static constexpr TypeID c_Void = 0;
+
+	public:
+		TypeTable();
+
+		// Keeps all storage for the next compile, void stays TypeID 0
+		void Clear();
+
+		TypeID Intern(const Type& type);
+
+		// 'name' unqualified in the global scope is checked for built in types such as 'float', 'float4' or 'int3x3', everything else is a Named type
+		TypeID FromName(const SymbolTable& symbols, ScopeID scope, SymbolID name);
+
+		const Type& operator[](TypeID type) const { return m_Types[type]; }
+
+		std::size_t Size() const { return m_Types.size(); }
+
+		// Appends the FIL type section to 'types', names of Named types are appended to 'names' and their offsets point into it
+		void Emit(const SymbolTable& symbols, std::vector<FIL::Type>& types, std::vector<std::uint8_t>& names);
+
+	private:
+		static std::uint64_t Hash(const Type& type);
+
+		static bool ParseBuiltin(std::string_view name, Type& type);
+
+		void GrowSlots();
+
+	private:
+		std::vector<Type>   m_Types;
+		std::vector<TypeID> m_Slots;
+
+		std::vector<TypeID> m_GlobalNameTypes; // Per SymbolID, so each distinct unqualified name is only parsed once
+		std::string         m_Name;
+	};
+} // namespace Frertex::Compiler
@@ -34,9 +34,81 @@ namespace Frertex::FIL
 		InOut = In | Out
 	};
 
+	enum class ETypeClass : std::uint8_t
+	{
+		Void = 0,
+		Bool,
+		Int,
+		UInt,
+		Half,
+		Float,
+		Double,
+		Named // Not built in, identified by its fully qualified name
+	};
+
+	// Code is a stream of 32 bit words, every instruction starts with 'opcode | wordCount << 16' where wordCount includes that first word.
+	// Instructions with a result follow it with <type> <result>, results and blocks are numbered from 0 per function.
+	enum class EOpcode : std::uint16_t
+	{
+		Nop = 0,
+		Label,     // Label <block>, starts a basic block
+		Parameter, // Parameter <type> <result> <index>
+		Constant,  // Constant <type> <result> <constant>, constant indexes Binary::Constants
+		Undefined, // Undefined <type> <result>
+
+		// <type> <result> <operand>
+		Negate,
+		LogicalNot,
+		BitNot,
+
+		// <type> <result> <lhs> <rhs>
+		BitOr,
+		BitXor,
+		BitAnd,
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		ShiftLeft,
+		ShiftRight,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Remainder,
+
+		Call,              // Call <type> <result> <function> <arguments>..., function indexes Binary::Functions
+		Phi,               // Phi <type> <result> (<value> <block>)...
+		Store,             // Store <parameter> <value>, writes an out parameter
+		Branch,            // Branch <block>
+		BranchConditional, // BranchConditional <condition> <true block> <false block>
+		Return             // Return
+	};
+
 	EEntrypointType EntrypointTypeFromString(std::string_view str);
 	ETypeQualifier  TypeQualifierFromString(std::string_view str);
 
+	// Every TypeID indexes Binary::Types
+	struct Type
+	{
+	public:
+		ETypeClass    Class;
+		std::uint8_t  Rows;                   // Vector width, 1 for scalars
+		std::uint8_t  Columns;                // Matrix columns, 1 for scalars and vectors
+		std::uint64_t NameOffset, NameLength; // Named types only
+	};
+
+	// Values are widened to 64 bits whatever the width of the type: bools are 0 or 1, ints are sign extended and uints zero extended from 32 bits,
+	// floating point values are stored as the bit pattern of the double they convert to exactly
+	struct Constant
+	{
+	public:
+		std::uint64_t TypeID;
+		std::uint64_t Value;
+	};
+
 	struct EntrypointParameter
 	{
 	public:
@@ -60,8 +132,11 @@ namespace Frertex::FIL
 	public:
 		ETypeQualifier Qualifier;
 		std::uint64_t  TypeID;
+
+		friend bool operator==(const FunctionParameter& lhs, const FunctionParameter& rhs) = default;
 	};
 
+	// Functions with the same code and signature may share one code range, just like functions with the same name may share one name
 	struct Function
 	{
 	public:
@@ -77,10 +152,15 @@ namespace Frertex::FIL
 	public:
 		std::vector<Entrypoint>    Entrypoints;
 		std::vector<Function>      Functions;
+		std::vector<Type>          Types;
+		std::vector<Constant>      Constants;
 		std::vector<std::uint8_t>  Strings;
 		std::vector<std::uint32_t> Code;
 	};
 
+	// Major, minor and patch in the top byte, the two middle ones and the low byte, written by WriteBinary
+	static constexpr std::uint32_t c_Version = 0x0100'0300; // 1.3.0
+
 	Binary      ParseBinary(Utils::View<std::uint8_t> data);
 	std::size_t WriteBinary(const Binary& binary, std::vector<std::uint8_t>& data);
 } // namespace Frertex::FIL
\ No newline at end of file
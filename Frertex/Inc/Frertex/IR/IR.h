@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Frertex/FIL/FIL.h"
+#include "Frertex/Utils/View.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace Frertex::IR
+{
+	// Instructions, blocks and functions refer to each other by index into the Module
+	using Ref = std::uint32_t;
+
+	static constexpr Ref c_NoRef = ~0U;
+
+	struct Instruction
+	{
+	public:
+		FIL::EOpcode  Opcode;
+		std::uint16_t OperandCount;
+		std::uint32_t Type;         // FIL TypeID of the result, c_NoRef for instructions without one
+		std::uint32_t FirstOperand; // Into the operand arena
+		Ref           Block;
+		Ref           FirstUse; // Head of the list of operands using the result
+		std::uint32_t Pad = 0;
+		std::uint64_t Node; // The AST node it was lowered from
+	};
+
+	struct Use
+	{
+	public:
+		Ref           User;
+		std::uint32_t Operand; // Index into the operands of User
+		Ref           Next;
+	};
+
+	// Instructions of a block are contiguous, so are the blocks and instructions of a function
+	struct Block
+	{
+	public:
+		Ref           FirstInstruction;
+		std::uint32_t InstructionCount;
+	};
+
+	struct Function
+	{
+	public:
+		Ref           FirstBlock;
+		std::uint32_t BlockCount;
+		Ref           FirstInstruction;
+		std::uint32_t InstructionCount;
+		std::uint32_t Declaration; // Index of the function declaration it was lowered from
+	};
+
+	// SSA form between the AST and FIL code. All instructions of a compile live in one arena and operands and uses in two more, so building a function only ever appends to three vectors and iterating one walks memory in order.
+	// Instructions are appended to the newest block of the newest function, which keeps every block and function contiguous, and Clear keeps all storage for the next compile.
+	class Module
+	{
+	public:
+		void Clear();
+
+		// Starts a function, instructions go into its first block once BeginBlock is called
+		std::uint32_t BeginFunction(std::uint32_t declaration);
+		Ref           BeginBlock();
+		Ref           CurrentBlock() const { return static_cast<Ref>(m_Blocks.size() - 1); }
+
+		Ref Add(FIL::EOpcode opcode, std::uint32_t type, Utils::View<std::uint32_t> operands, std::uint64_t node = ~0ULL);
+
+		// Keeps use lists up to date, immediate operands are stored as is
+		void SetOperand(Ref instruction, std::uint32_t operand, std::uint32_t value);
+		// Points every use of 'from' at 'to'
+		void ReplaceAllUses(Ref from, Ref to);
+		// Turns 'instruction' into a Constant in place, dropping the uses of its operands. It needs at least one operand.
+		void SetConstant(Ref instruction, std::uint32_t constant);
+		// Turns 'instruction' into a Nop, nothing may use its result
+		void Remove(Ref instruction);
+
+		const Instruction& operator[](Ref instruction) const { return m_Instructions[instruction]; }
+
+		Utils::View<std::uint32_t> Operands(Ref instruction) const
+		{
+			const Instruction& value = m_Instructions[instruction];
+			return { m_Operands.data() + value.FirstOperand, m_Operands.data() + value.FirstOperand + value.OperandCount };
+		}
+
+		const Use&      GetUse(Ref use) const { return m_Uses[use]; }
+		const Block&    GetBlock(Ref block) const { return m_Blocks[block]; }
+		const Function& GetFunction(std::uint32_t function) const { return m_Functions[function]; }
+
+		std::size_t InstructionCount() const { return m_Instructions.size(); }
+		std::size_t BlockCount() const { return m_Blocks.size(); }
+		std::size_t FunctionCount() const { return m_Functions.size(); }
+
+		// Appends the FIL code of 'function', results and blocks are renumbered from 0, Nops are left out and Constant operands are mapped through 'constants'
+		void Emit(std::uint32_t function, std::vector<std::uint32_t>& code, Utils::View<std::uint32_t> constants);
+
+		static bool HasResult(FIL::EOpcode opcode);
+		// Whether operand 'operand' refers to an instruction, the rest are immediates such as block and parameter indices
+		static bool IsValueOperand(FIL::EOpcode opcode, std::uint32_t operand);
+		// Whether operand 'operand' refers to a block
+		static bool IsBlockOperand(FIL::EOpcode opcode, std::uint32_t operand);
+
+	private:
+		void AddUse(Ref instruction, std::uint32_t operand);
+		void RemoveUse(Ref instruction, std::uint32_t operand);
+
+	private:
+		std::vector<Instruction>   m_Instructions;
+		std::vector<std::uint32_t> m_Operands;
+		std::vector<Use>           m_Uses;
+		std::vector<Block>         m_Blocks;
+		std::vector<Function>      m_Functions;
+
+		Ref m_FreeUses = c_NoRef; // Uses removed by SetOperand, reused before growing m_Uses
+
+		std::vector<std::uint32_t> m_Results; // Result numbers of the function being emitted
+	};
+} // namespace Frertex::IR
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Frertex/Tokenizer/Token.h"
+
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+
+namespace Frertex::Parser
+{
+	// Both return false if the literal is malformed or does not fit, digit separators are skipped
+	bool DecodeIntegerLiteral(Tokenizer::ETokenClass clazz, std::string_view literal, std::uint64_t& value);
+	// 'scratch' holds the digits of literals with separators
+	bool DecodeFloatLiteral(Tokenizer::ETokenClass clazz, std::string_view literal, double& value, std::string& scratch);
+} // namespace Frertex::Parser
\ No newline at end of file
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "Profile.h"
+#include "TokenSource.h"
 #include "Frertex/AST/AST.h"
+#include "Frertex/Tokenizer/Tokenizer.h"
 #include "Frertex/Utils/View.h"
 
+#include <string>
+
 namespace Frertex::Parser
 {
 	struct ParseResult
@@ -21,20 +26,74 @@ namespace Frertex::Parser
 		std::string_view       String;
 	};
 
+	// An operator waiting for its operands while an expression is parsed, Operator is None for an open '('
+	struct PendingOperator
+	{
+	public:
+		AST::EOperator   Operator;
+		std::uint8_t     Precedence;
+		Tokenizer::Token Token;
+	};
+
+	struct ReparseResult
+	{
+	public:
+		std::size_t ReusedDeclarations   = 0;
+		std::size_t ReparsedDeclarations = 0;
+	};
+
+	struct ParseOptions
+	{
+	public:
+		// Function bodies become LazyCompoundStatement nodes holding their token range, see State::ExpandLazyBody
+		bool LazyFunctionBodies = false;
+	};
+
 	class State
 	{
 	public:
-		AST::AST Parse(std::string_view source, Utils::View<Tokenizer::Token> tokens);
+		AST::AST Parse(std::string_view source, Utils::View<Tokenizer::Token> tokens, ParseOptions options = {});
+		// Parses into 'ast', reusing its node storage
+		void     Parse(AST::AST& ast, std::string_view source, Utils::View<Tokenizer::Token> tokens, ParseOptions options = {});
+		AST::AST Parse(std::string_view source, TokenSource& tokens);
+
+		// Updates 'ast' after 'tokens' were updated by Tokenizer::Retokenize, top-level declarations outside the retokenized range are kept and shifted
+		ReparseResult Reparse(AST::AST& ast, std::string_view source, Utils::View<Tokenizer::Token> tokens, const Tokenizer::Edit& edit, const Tokenizer::RetokenizeResult& retokenized, ParseOptions options = {});
+
+		// Parses a LazyCompoundStatement in place, 'tokens' has to be the same tokens 'ast' was parsed from
+		bool ExpandLazyBody(AST::AST& ast, std::uint64_t node, std::string_view source, Utils::View<Tokenizer::Token> tokens);
+
+		// Tokenizes on a second thread and parses declarations as their tokens arrive through a ring of 'ringCapacity' tokens
+		AST::AST ParsePipelined(std::string_view source, std::size_t ringCapacity = 16384);
+
+		// Only filled in when built with FRERTEX_PARSER_PROFILING
+		const Profile& GetProfile() const { return m_Profile; }
+
+		void ResetProfile() { m_Profile = {}; }
 
 	private:
-		void ReportError(Utils::View<Tokenizer::Token> tokens, std::size_t point, std::string message);
+		friend struct RuleProfiler;
+
+		void ReportError(Utils::View<Tokenizer::Token> tokens, std::size_t point, std::string_view message);
 
 		std::string_view GetSource(Tokenizer::Token token);
 
 		bool        TestToken(Tokenizer::Token token, TokenPattern pattern);
 		std::size_t FindEndToken(Utils::View<Tokenizer::Token> tokens, std::size_t offset, TokenPattern open, TokenPattern close);
 
+		// Both return false if the literal can not be decoded, the literal rule then fails
+		bool StoreIntegerValue(Utils::View<Tokenizer::Token> tokens, std::uint64_t node);
+		bool StoreFloatValue(Utils::View<Tokenizer::Token> tokens, std::uint64_t node);
+
+		std::size_t FindDeclarationEnd(TokenSource& tokens);
+
+		// Frees a node of a failed alternative
+		void Backtrack(std::uint64_t node);
+
+		void ShiftDeclaration(std::uint64_t node, std::uint64_t tokenDelta, std::uint64_t byteDelta);
+
 		ParseResult ParseDeclarations(Utils::View<Tokenizer::Token> tokens);
+		ParseResult ParseDeclarations(TokenSource& tokens);
 		ParseResult ParseDeclaration(Utils::View<Tokenizer::Token> tokens);
 		ParseResult ParseFunctionDeclaration(Utils::View<Tokenizer::Token> tokens);
 
@@ -42,6 +101,13 @@ namespace Frertex::Parser
 		ParseResult ParseStatement(Utils::View<Tokenizer::Token> tokens);
 		ParseResult ParseEmptyStatement(Utils::View<Tokenizer::Token> tokens);
 		ParseResult ParseCompoundStatement(Utils::View<Tokenizer::Token> tokens);
+		ParseResult ParseLazyCompoundStatement(Utils::View<Tokenizer::Token> tokens);
+		ParseResult ParseExpressionStatement(Utils::View<Tokenizer::Token> tokens);
+
+		bool IsDeclarationStart(Utils::View<Tokenizer::Token> tokens);
+
+		ParseResult ParseExpression(Utils::View<Tokenizer::Token> tokens);
+		void        ReduceOperator();
 
 		ParseResult ParseParameters(Utils::View<Tokenizer::Token> tokens);
 		ParseResult ParseParameter(Utils::View<Tokenizer::Token> tokens);
@@ -68,8 +134,19 @@ namespace Frertex::Parser
 		ParseResult ParseIdentifier(Utils::View<Tokenizer::Token> tokens);
 
 	private:
-		std::string_view m_Source;
+		std::string_view              m_Source;
+		Utils::View<Tokenizer::Token> m_Tokens;
+		ParseOptions                  m_Options;
 
 		AST::AST m_AST;
+
+		// Shared by nested expressions, each ParseExpression only touches the entries above where it started
+		std::vector<std::uint64_t>   m_Operands;
+		std::vector<PendingOperator> m_Operators;
+
+		std::string m_LiteralScratch; // Float literals with digit separators are decoded from here
+
+		Profile       m_Profile;
+		std::uint64_t m_BacktrackedNodes = 0;
 	};
 } // namespace Frertex::Parser
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <string_view>
+
+// Per rule counters in the parser, enabled with 'premake5 --parser-profiling' or by defining FRERTEX_PARSER_PROFILING=1
+#ifndef FRERTEX_PARSER_PROFILING
+	#define FRERTEX_PARSER_PROFILING 0
+#endif
+
+namespace Frertex::Parser
+{
+	enum class ERule : std::uint8_t
+	{
+		Declarations = 0,
+		Declaration,
+		FunctionDeclaration,
+
+		Statements,
+		Statement,
+		EmptyStatement,
+		CompoundStatement,
+		LazyCompoundStatement,
+		ExpressionStatement,
+
+		Expression,
+
+		Parameters,
+		Parameter,
+		Arguments,
+		Argument,
+		Attributes,
+		Attribute,
+
+		Typename,
+		TypeQualifier,
+
+		Literal,
+		IntegerLiteral,
+		FloatLiteral,
+		BoolLiteral,
+		BinaryIntegerLiteral,
+		OctalIntegerLiteral,
+		DecimalIntegerLiteral,
+		HexIntegerLiteral,
+		DecimalFloatLiteral,
+		HexFloatLiteral,
+
+		Identifier,
+
+		COUNT
+	};
+
+	std::string_view RuleToString(ERule rule);
+
+	struct RuleStats
+	{
+	public:
+		std::uint64_t Attempts       = 0;
+		std::uint64_t Successes      = 0;
+		std::uint64_t TokensConsumed = 0;
+		std::uint64_t NodesAllocated = 0; // Including nodes that were freed again
+		std::uint64_t NodesFreed     = 0; // Freed by backtracking out of a failed alternative
+		std::uint64_t Nanoseconds    = 0; // Inclusive, recursive rules count nested calls again
+	};
+
+	struct Profile
+	{
+	public:
+		RuleStats&       operator[](ERule rule) { return Rules[static_cast<std::size_t>(rule)]; }
+		const RuleStats& operator[](ERule rule) const { return Rules[static_cast<std::size_t>(rule)]; }
+
+	public:
+		std::array<RuleStats, static_cast<std::size_t>(ERule::COUNT)> Rules {};
+	};
+} // namespace Frertex::Parser
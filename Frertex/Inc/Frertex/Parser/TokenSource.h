@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Frertex/Tokenizer/Token.h"
+#include "Frertex/Utils/RingBuffer.h"
+#include "Frertex/Utils/View.h"
+
+#include <vector>
+
+namespace Frertex::Parser
+{
+	// Pulls tokens out of a ring on demand, only the tokens that have not been consumed yet are kept
+	class TokenSource
+	{
+	public:
+		TokenSource(Utils::RingBuffer<Tokenizer::Token>& ring);
+
+		// Returns false if the stream ended before 'count' tokens were buffered
+		bool Request(std::size_t count);
+		void Consume(std::size_t count);
+
+		// Invalidated by the next call to Request
+		Utils::View<Tokenizer::Token> Window() const { return { m_Tokens.data() + m_Offset, m_Tokens.data() + m_Tokens.size() }; }
+
+		std::size_t Buffered() const { return m_Tokens.size() - m_Offset; }
+
+	private:
+		Utils::RingBuffer<Tokenizer::Token>* m_Ring;
+
+		std::vector<Tokenizer::Token> m_Tokens;
+		std::size_t                   m_Offset;
+		bool                          m_Ended;
+	};
+} // namespace Frertex::Parser
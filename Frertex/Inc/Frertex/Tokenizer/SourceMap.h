@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace Frertex::Tokenizer
+{
+	struct SourceLocation
+	{
+	public:
+		std::uint64_t Line   = 0;
+		std::uint64_t Column = 0;
+	};
+
+	struct SourceMap
+	{
+	public:
+		SourceMap();
+
+		void Reset();
+		void Build(const void* data, std::size_t size);
+		void ScanNewlines(const void* data, std::size_t begin, std::size_t end);
+
+		// Lines and columns are 1-based, columns count bytes
+		SourceLocation LineColumn(std::uint64_t offset) const;
+
+		std::uint64_t LineStart(std::uint64_t line) const;
+
+		std::uint64_t LineCount() const { return m_LineStarts.size(); }
+
+	private:
+		std::vector<std::uint64_t> m_LineStarts;
+	};
+} // namespace Frertex::Tokenizer
\ No newline at end of file
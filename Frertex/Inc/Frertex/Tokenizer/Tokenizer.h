@@ -1,10 +1,42 @@
 #pragma once
 
+#include "SourceMap.h"
 #include "Token.h"
+#include "Frertex/Utils/RingBuffer.h"
 
 #include <vector>
 
 namespace Frertex::Tokenizer
 {
+	struct Edit
+	{
+	public:
+		std::uint64_t Offset;
+		std::uint64_t RemovedLength;
+		std::uint64_t InsertedLength;
+	};
+
+	struct RetokenizeResult
+	{
+	public:
+		std::size_t FirstToken     = 0;
+		std::size_t RemovedTokens  = 0;
+		std::size_t InsertedTokens = 0;
+		std::size_t Iterations     = 0;
+	};
+
 	std::size_t Tokenize(const void* data, std::size_t size, std::vector<Token>& tokens);
-}
\ No newline at end of file
+	std::size_t Tokenize(const void* data, std::size_t size, std::vector<Token>& tokens, SourceMap& sourceMap);
+
+	// Same result as Tokenize, but writes a candidate token every iteration and only advances the output on included, non-empty tokens
+	std::size_t TokenizeBranchless(const void* data, std::size_t size, std::vector<Token>& tokens);
+
+	// Pushes tokens into 'ring' in batches as they are produced and closes it when done, meant to run on its own thread
+	std::size_t Tokenize(const void* data, std::size_t size, Utils::RingBuffer<Token>& ring);
+
+	// Advances up to 4 segments of the input in lockstep on one thread to overlap the LUT loads
+	std::size_t TokenizeInterleaved(const void* data, std::size_t size, std::vector<Token>& tokens, std::size_t streams = 4);
+
+	// Re-lexes an edited source in place, 'data' is the source with the edit already applied
+	RetokenizeResult Retokenize(const void* data, std::size_t size, std::vector<Token>& tokens, const Edit& edit);
+} // namespace Frertex::Tokenizer
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <string_view>
+
+namespace Frertex::Utils
+{
+	// Fast non-cryptographic 64 bit hashing, stable across runs so hashes can be stored on disk
+	inline std::uint64_t HashMix(std::uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58'476D'1CE4'E5B9ULL;
+		value ^= value >> 27;
+		value *= 0x94D0'49BB'1331'11EBULL;
+		value ^= value >> 31;
+		return value;
+	}
+
+	inline std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t value)
+	{
+		return HashMix(seed ^ (value * 0x9E37'79B9'7F4A'7C15ULL));
+	}
+
+	inline std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed = 0)
+	{
+		const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+		std::uint64_t       hash  = seed ^ (size * 0xC2B2'AE3D'27D4'EB4FULL);
+		while (size >= 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, bytes, 8);
+			hash  = HashCombine(hash, word);
+			bytes += 8;
+			size  -= 8;
+		}
+		if (size)
+		{
+			std::uint64_t word = 0;
+			std::memcpy(&word, bytes, size);
+			hash = HashCombine(hash, word);
+		}
+		return hash;
+	}
+
+	inline std::uint64_t HashString(std::string_view string, std::uint64_t seed = 0)
+	{
+		return HashBytes(string.data(), string.size(), seed);
+	}
+} // namespace Frertex::Utils
@@ -0,0 +1,24 @@
+// Auto generated
+
+#pragma once
+
+#include <cstdint>
+
+#include <string_view>
+
+namespace Frertex::Utils::Lookups
+{
+	static constexpr std::uint32_t c_NotFound = ~0U;
+
+	static constexpr std::string_view c_EntrypointTypeNames[14] { "VertexShader", "TessellationControlShader", "TessellationEvaluationShader", "GeometryShader", "FragmentShader", "ComputeShader", "RayGenShader", "AnyHitShader", "ClosestHitShader", "MissShader", "IntersectionShader", "CallableShader", "TaskShader", "MeshShader" };
+	// Index of 'str' in c_EntrypointTypeNames, c_NotFound if it is not one of them
+	std::uint32_t FindEntrypointType(std::string_view str);
+
+	static constexpr std::string_view c_TypeQualifierNames[3] { "in", "out", "inout" };
+	// Index of 'str' in c_TypeQualifierNames, c_NotFound if it is not one of them
+	std::uint32_t FindTypeQualifier(std::string_view str);
+
+	static constexpr std::string_view c_AttributeNames[15] { "VertexShader", "TessellationControlShader", "TessellationEvaluationShader", "GeometryShader", "FragmentShader", "ComputeShader", "RayGenShader", "AnyHitShader", "ClosestHitShader", "MissShader", "IntersectionShader", "CallableShader", "TaskShader", "MeshShader", "Position" };
+	// Index of 'str' in c_AttributeNames, c_NotFound if it is not one of them
+	std::uint32_t FindAttribute(std::string_view str);
+} // namespace Frertex::Utils::Lookups
\ No newline at end of file
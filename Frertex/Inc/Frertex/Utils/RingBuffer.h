@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <thread>
+
+namespace Frertex::Utils
+{
+	// Lock-free ring for exactly one producer thread and one consumer thread
+	template <class T>
+	struct RingBuffer
+	{
+	public:
+		RingBuffer(std::size_t capacity)
+			: m_Capacity(std::bit_ceil(capacity < 2 ? 2 : capacity)),
+			  m_Mask(m_Capacity - 1),
+			  m_Items(std::make_unique<T[]>(m_Capacity))
+		{
+		}
+
+		std::size_t Capacity() const { return m_Capacity; }
+
+		// Producer side
+		std::size_t TryPush(const T* items, std::size_t count)
+		{
+			std::size_t head = m_Head.load(std::memory_order_relaxed);
+			if (m_Capacity - (head - m_CachedTail) < count)
+				m_CachedTail = m_Tail.load(std::memory_order_acquire);
+
+			std::size_t free = m_Capacity - (head - m_CachedTail);
+			if (count > free)
+				count = free;
+			for (std::size_t i = 0; i < count; ++i)
+				m_Items[(head + i) & m_Mask] = items[i];
+			m_Head.store(head + count, std::memory_order_release);
+			return count;
+		}
+
+		void Push(const T* items, std::size_t count)
+		{
+			while (count)
+			{
+				std::size_t pushed = TryPush(items, count);
+				items              += pushed;
+				count              -= pushed;
+				if (!pushed)
+					std::this_thread::yield();
+			}
+		}
+
+		void Close() { m_Closed.store(true, std::memory_order_release); }
+
+		// Consumer side
+		std::size_t TryPop(T* items, std::size_t count)
+		{
+			std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+			if (m_CachedHead - tail < count)
+				m_CachedHead = m_Head.load(std::memory_order_acquire);
+
+			std::size_t available = m_CachedHead - tail;
+			if (count > available)
+				count = available;
+			for (std::size_t i = 0; i < count; ++i)
+				items[i] = m_Items[(tail + i) & m_Mask];
+			m_Tail.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+		// Blocks until at least one item is available, returns 0 once the ring is closed and drained
+		std::size_t Pop(T* items, std::size_t count)
+		{
+			while (true)
+			{
+				bool        closed = m_Closed.load(std::memory_order_acquire);
+				std::size_t popped = TryPop(items, count);
+				if (popped || closed)
+					return popped;
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		std::size_t          m_Capacity;
+		std::size_t          m_Mask;
+		std::unique_ptr<T[]> m_Items;
+
+		// Producer and consumer state live on separate cache lines
+		alignas(64) std::atomic<std::size_t> m_Head { 0 };
+		std::size_t                          m_CachedTail = 0;
+		alignas(64) std::atomic<std::size_t> m_Tail { 0 };
+		std::size_t                          m_CachedHead = 0;
+		alignas(64) std::atomic<bool> m_Closed { false };
+	};
+} // namespace Frertex::Utils
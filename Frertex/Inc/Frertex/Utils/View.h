@@ -31,29 +31,29 @@ namespace Frertex::Utils
 
 		template <std::size_t N>
 		View(const std::array<BaseT, N>& arr)
-			: m_Begin(&arr[0]),
-			  m_End(&arr[N])
+			: m_Begin(arr.data()),
+			  m_End(arr.data() + N)
 		{
 		}
 
 		template <std::size_t N>
 		View(const std::array<ConstT, N>& arr)
-			: m_Begin(&arr[0]),
-			  m_End(&arr[N])
+			: m_Begin(arr.data()),
+			  m_End(arr.data() + N)
 		{
 		}
 
 		template <class Alloc>
 		View(const std::vector<BaseT, Alloc>& vec)
-			: m_Begin(&vec.front()),
-			  m_End(&vec.back() + 1ULL)
+			: m_Begin(vec.data()),
+			  m_End(vec.data() + vec.size())
 		{
 		}
 
 		template <class Alloc>
 		View(const std::vector<ConstT, Alloc>& vec)
-			: m_Begin(&vec.front()),
-			  m_End(&vec.back() + 1ULL)
+			: m_Begin(vec.data()),
+			  m_End(vec.data() + vec.size())
 		{
 		}
 
@@ -107,15 +107,15 @@ namespace Frertex::Utils
 
 		template <std::size_t N>
 		Span(std::array<BaseT, N>& arr)
-			: m_Begin(&arr[0]),
-			  m_End(&arr[N])
+			: m_Begin(arr.data()),
+			  m_End(arr.data() + N)
 		{
 		}
 
 		template <class Alloc>
 		Span(std::vector<BaseT, Alloc>& vec)
-			: m_Begin(&vec.front()),
-			  m_End(&vec.back() + 1ULL)
+			: m_Begin(vec.data()),
+			  m_End(vec.data() + vec.size())
 		{
 		}
 
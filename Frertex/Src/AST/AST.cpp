@@ -1,5 +1,6 @@
 #include "Frertex/AST/AST.h"
 
+#include <algorithm>
 #include <bit>
 
 namespace Frertex::AST
@@ -14,6 +15,11 @@ namespace Frertex::AST
 		case EType::Statements: return "Statements";
 		case EType::EmptyStatement: return "EmptyStatement";
 		case EType::CompoundStatement: return "CompoundStatement";
+		case EType::LazyCompoundStatement: return "LazyCompoundStatement";
+		case EType::ExpressionStatement: return "ExpressionStatement";
+		case EType::BinaryExpression: return "BinaryExpression";
+		case EType::UnaryExpression: return "UnaryExpression";
+		case EType::CallExpression: return "CallExpression";
 		case EType::Parameters: return "Parameters";
 		case EType::Parameter: return "Parameter";
 		case EType::Arguments: return "Arguments";
@@ -26,19 +32,70 @@ namespace Frertex::AST
 		case EType::FloatLiteral: return "FloatLiteral";
 		case EType::BoolLiteral: return "BoolLiteral";
 		case EType::Identifier: return "Identifier";
+		case EType::Symbol: return "Symbol";
 		}
 		return "Unknown";
 	}
 
+	std::string_view OperatorToString(EOperator op)
+	{
+		switch (op)
+		{
+		case EOperator::None: return "None";
+		case EOperator::Assign: return "=";
+		case EOperator::LogicalOr: return "||";
+		case EOperator::LogicalAnd: return "&&";
+		case EOperator::BitOr: return "|";
+		case EOperator::BitXor: return "^";
+		case EOperator::BitAnd: return "&";
+		case EOperator::Equal: return "==";
+		case EOperator::NotEqual: return "!=";
+		case EOperator::Less: return "<";
+		case EOperator::LessEqual: return "<=";
+		case EOperator::Greater: return ">";
+		case EOperator::GreaterEqual: return ">=";
+		case EOperator::ShiftLeft: return "<<";
+		case EOperator::ShiftRight: return ">>";
+		case EOperator::Add: return "+";
+		case EOperator::Subtract: return "-";
+		case EOperator::Multiply: return "*";
+		case EOperator::Divide: return "/";
+		case EOperator::Remainder: return "%";
+		case EOperator::Negate: return "-";
+		case EOperator::Plus: return "+";
+		case EOperator::LogicalNot: return "!";
+		case EOperator::BitNot: return "~";
+		}
+		return "None";
+	}
+
+	static bool HasTokenRange(const Node& node)
+	{
+		return node.Type == EType::FunctionDeclaration || node.Type == EType::LazyCompoundStatement;
+	}
+
 	AST::AST()
 		: m_Nodes(64),
 		  m_AllocationMap(1),
 		  m_PreviousAllocation(0),
 		  m_Size(0),
+		  m_TypeIndexDirty(true),
 		  m_RootNode(~0ULL)
 	{
 	}
 
+	void AST::Clear()
+	{
+		std::fill(m_AllocationMap.begin(), m_AllocationMap.end(), 0ULL);
+		m_PreviousAllocation = 0;
+		m_Size               = 0;
+		m_RootNode           = ~0ULL;
+		m_TypeIndexDirty     = true;
+		m_Integers.clear();
+		m_Floats.clear();
+		m_TokenRanges.clear();
+	}
+
 	std::uint64_t AST::GetChild(std::uint64_t node, std::uint64_t index) const
 	{
 		if (node >= m_Nodes.size())
@@ -67,6 +124,7 @@ namespace Frertex::AST
 
 		m_AllocationMap[allocationMapIndex] = m_AllocationMap[allocationMapIndex] | (1ULL << allocationMapBit);
 		m_PreviousAllocation                = node;
+		m_TypeIndexDirty                    = true;
 		++m_Size;
 
 		new (&m_Nodes[node]) Node { std::move(value) };
@@ -84,6 +142,7 @@ namespace Frertex::AST
 		m_AllocationMap[allocationMapIndex] &= ~(1ULL << allocationMapBit);
 		if (node < m_PreviousAllocation)
 			m_PreviousAllocation = node;
+		m_TypeIndexDirty = true;
 		--m_Size;
 
 		new (&m_Nodes[node]) Node {};
@@ -91,22 +150,31 @@ namespace Frertex::AST
 
 	void AST::FreeFull(std::uint64_t node, bool freeSiblings)
 	{
+		// Over an explicit worklist, expression chains nest far deeper than recursion allows
 		if (node >= m_Nodes.size())
 			return;
 
-		auto& n = m_Nodes[node];
-		FreeFull(n.Child, true);
-		if (freeSiblings)
-			FreeFull(n.NextSibling, true);
-		Free(node);
+		m_FreeList.clear();
+		m_FreeList.push_back(node);
+		while (!m_FreeList.empty())
+		{
+			std::uint64_t current = m_FreeList.back();
+			m_FreeList.pop_back();
+
+			const Node& value = m_Nodes[current];
+			if (value.Child < m_Nodes.size())
+				m_FreeList.push_back(value.Child);
+			if ((current != node || freeSiblings) && value.NextSibling < m_Nodes.size())
+				m_FreeList.push_back(value.NextSibling);
+			Free(current);
+		}
 	}
 
 	void AST::SetParent(std::uint64_t child, std::uint64_t parent)
 	{
 		if (parent < m_Nodes.size())
 			m_Nodes[parent].Child = child < m_Nodes.size() ? child : ~0ULL;
-		if (child < m_Nodes.size())
-			m_Nodes[child].Parent = parent < m_Nodes.size() ? parent : ~0ULL;
+		SetParents(child, parent < m_Nodes.size() ? parent : ~0ULL);
 	}
 
 	void AST::SetSiblings(std::uint64_t first, std::uint64_t second)
@@ -115,6 +183,15 @@ namespace Frertex::AST
 			m_Nodes[first].NextSibling = second < m_Nodes.size() ? second : ~0ULL;
 		if (second < m_Nodes.size())
 			m_Nodes[second].PreviousSibling = first < m_Nodes.size() ? first : ~0ULL;
+		if (first < m_Nodes.size())
+			SetParents(second, m_Nodes[first].Parent);
+	}
+
+	void AST::SetParents(std::uint64_t first, std::uint64_t parent)
+	{
+		// Stops at the first sibling that already has the parent, the rest of the list was linked before
+		for (std::uint64_t node = first; node < m_Nodes.size() && m_Nodes[node].Parent != parent; node = m_Nodes[node].NextSibling)
+			m_Nodes[node].Parent = parent;
 	}
 
 	std::uint64_t AST::FindNextAvailableNode() const
@@ -135,11 +212,110 @@ namespace Frertex::AST
 		return ~0ULL;
 	}
 
+	Utils::View<std::uint64_t> AST::NodesOfType(EType type) const
+	{
+		std::size_t index = static_cast<std::size_t>(type);
+		if (index >= c_TypeCount)
+			return {};
+
+		if (m_TypeIndexDirty)
+		{
+			for (auto& nodes : m_TypeIndex)
+				nodes.clear();
+			for (std::uint64_t i = 0; i < m_AllocationMap.size(); ++i)
+			{
+				for (std::uint64_t bits = m_AllocationMap[i]; bits; bits &= bits - 1)
+				{
+					std::uint64_t node      = i << 6 | std::countr_zero(bits);
+					std::size_t   nodeIndex = static_cast<std::size_t>(m_Nodes[node].Type);
+					if (nodeIndex < c_TypeCount)
+						m_TypeIndex[nodeIndex].emplace_back(node);
+				}
+			}
+			m_TypeIndexDirty = false;
+		}
+
+		auto& nodes = m_TypeIndex[index];
+		return { nodes.data(), nodes.data() + nodes.size() };
+	}
+
+	void AST::SetType(std::uint64_t node, EType type)
+	{
+		if (node >= m_Nodes.size())
+			return;
+
+		m_Nodes[node].Type = type;
+		m_TypeIndexDirty   = true;
+	}
+
+	std::uint32_t AST::AddInteger(std::uint64_t value)
+	{
+		m_Integers.emplace_back(value);
+		return static_cast<std::uint32_t>(m_Integers.size() - 1);
+	}
+
+	std::uint32_t AST::AddFloat(double value)
+	{
+		m_Floats.emplace_back(value);
+		return static_cast<std::uint32_t>(m_Floats.size() - 1);
+	}
+
+	std::uint64_t AST::IntegerValue(std::uint64_t node) const
+	{
+		if (node >= m_Nodes.size() || m_Nodes[node].Type != EType::IntegerLiteral || m_Nodes[node].Value >= m_Integers.size())
+			return 0;
+		return m_Integers[m_Nodes[node].Value];
+	}
+
+	double AST::FloatValue(std::uint64_t node) const
+	{
+		if (node >= m_Nodes.size() || m_Nodes[node].Type != EType::FloatLiteral || m_Nodes[node].Value >= m_Floats.size())
+			return 0.0;
+		return m_Floats[m_Nodes[node].Value];
+	}
+
+	bool AST::BoolValue(std::uint64_t node) const
+	{
+		if (node >= m_Nodes.size() || m_Nodes[node].Type != EType::BoolLiteral)
+			return false;
+		return m_Nodes[node].Value == 1;
+	}
+
+	EOperator AST::Operator(std::uint64_t node) const
+	{
+		if (node >= m_Nodes.size() || (m_Nodes[node].Type != EType::BinaryExpression && m_Nodes[node].Type != EType::UnaryExpression))
+			return EOperator::None;
+		return static_cast<EOperator>(m_Nodes[node].Value);
+	}
+
+	std::uint32_t AST::AddTokenRange(TokenRange range)
+	{
+		m_TokenRanges.emplace_back(range);
+		return static_cast<std::uint32_t>(m_TokenRanges.size() - 1);
+	}
+
+	void AST::SetTokenRange(std::uint64_t node, TokenRange range)
+	{
+		if (node >= m_Nodes.size() || !HasTokenRange(m_Nodes[node]))
+			return;
+		if (m_Nodes[node].Value >= m_TokenRanges.size())
+			m_Nodes[node].Value = AddTokenRange(range);
+		else
+			m_TokenRanges[m_Nodes[node].Value] = range;
+	}
+
+	TokenRange AST::TokenRangeOf(std::uint64_t node) const
+	{
+		if (node >= m_Nodes.size() || !HasTokenRange(m_Nodes[node]) || m_Nodes[node].Value >= m_TokenRanges.size())
+			return {};
+		return m_TokenRanges[m_Nodes[node].Value];
+	}
+
 	bool AST::IsAllocated(std::uint64_t node) const
 	{
 		std::uint64_t index = node >> 6;
-		if (index > m_AllocationMap.size()) return false;
+		if (index >= m_AllocationMap.size()) return false;
 		std::uint64_t bit = node & 0x3F;
-		return m_AllocationMap[index] & bit;
+		return (m_AllocationMap[index] >> bit) & 1;
 	}
 } // namespace Frertex::AST
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "Frertex/AST/Dump.h"
+
+#include <bit>
+#include <cstring>
+
+#include <fmt/compile.h>
+
+namespace Frertex::AST
+{
+	static constexpr char             c_ASTMagic[4]   = { 'F', 'A', 'S', 'T' };
+	static constexpr char             c_TokenMagic[4] = { 'F', 'T', 'O', 'K' };
+	static constexpr std::uint8_t     c_DumpVersion   = 1;
+	static constexpr std::uint8_t     c_ASTEnd        = 0x7F; // Stands in for the type after the last node
+	static constexpr std::string_view c_Indent        = "                                                                ";
+
+	static_assert(c_TypeCount < c_ASTEnd, "Node types have to fit a one byte varint below the end marker");
+
+	static bool HasValue(EType type)
+	{
+		switch (type)
+		{
+		case EType::IntegerLiteral:
+		case EType::FloatLiteral:
+		case EType::BoolLiteral:
+		case EType::BinaryExpression:
+		case EType::UnaryExpression:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static std::uint64_t NodeValue(const AST& ast, std::uint64_t node)
+	{
+		switch (ast[node].Type)
+		{
+		case EType::IntegerLiteral: return ast.IntegerValue(node);
+		case EType::FloatLiteral: return std::bit_cast<std::uint64_t>(ast.FloatValue(node));
+		case EType::BoolLiteral: return ast.BoolValue(node) ? 1 : 0;
+		case EType::BinaryExpression:
+		case EType::UnaryExpression:
+			return static_cast<std::uint64_t>(ast.Operator(node));
+		default: return 0;
+		}
+	}
+
+	static std::string_view SourceOf(std::string_view source, Tokenizer::Token token)
+	{
+		if (token.Start >= source.size())
+			return {};
+		return source.substr(token.Start, token.Length);
+	}
+
+	static bool ReadVarU64(const std::uint8_t*& data, const std::uint8_t* end, std::uint64_t& value)
+	{
+		value = 0;
+		for (std::uint32_t shift = 0; shift < 64; shift += 7)
+		{
+			if (data == end)
+				return false;
+			std::uint8_t byte = *data++;
+			value             |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+
+	static bool ReadVarI64(const std::uint8_t*& data, const std::uint8_t* end, std::int64_t& value)
+	{
+		std::uint64_t zigzag;
+		if (!ReadVarU64(data, end, zigzag))
+			return false;
+		value = static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1);
+		return true;
+	}
+
+	Dumper::Dumper(std::FILE* file, std::size_t flushSize)
+		: m_File(file),
+		  m_FlushSize(flushSize)
+	{
+	}
+
+	void Dumper::DumpAST(const AST& ast, std::uint64_t node, std::string_view source, EDumpFormat format)
+	{
+		bool binary = format == EDumpFormat::Binary;
+		if (binary)
+		{
+			m_Buffer.append(c_ASTMagic, c_ASTMagic + 4);
+			WriteU8(c_DumpVersion);
+		}
+
+		// Pre-order without a stack, climbing back up through Parent links
+		std::size_t   depth         = 0;
+		std::uint64_t previousStart = 0;
+		std::uint64_t current       = node;
+		while (current != ~0ULL)
+		{
+			const Node&   value = ast[current];
+			std::uint64_t data  = HasValue(value.Type) ? NodeValue(ast, current) : 0;
+			if (binary)
+				WriteNodeBinary(depth, value.Type, value.Token, data, previousStart);
+			else
+				WriteNodeText(depth, value.Type, value.Token, data, source);
+			MaybeFlush();
+
+			if (value.Child != ~0ULL)
+			{
+				current = value.Child;
+				++depth;
+				continue;
+			}
+			while (current != node && ast[current].NextSibling == ~0ULL)
+			{
+				current = ast[current].Parent;
+				--depth;
+			}
+			current = current != node ? ast[current].NextSibling : ~0ULL;
+		}
+
+		if (binary)
+			WriteU8(c_ASTEnd);
+		if (m_File)
+			Flush();
+	}
+
+	void Dumper::DumpTokens(Utils::View<Tokenizer::Token> tokens, std::string_view source, EDumpFormat format)
+	{
+		if (format == EDumpFormat::Binary)
+		{
+			m_Buffer.append(c_TokenMagic, c_TokenMagic + 4);
+			WriteU8(c_DumpVersion);
+			WriteVarU64(tokens.size());
+			std::uint64_t previousStart = 0;
+			for (auto& token : tokens)
+			{
+				WriteVarU64(static_cast<std::uint64_t>(token.Class));
+				WriteVarI64(static_cast<std::int64_t>(token.Start - previousStart));
+				WriteVarU64(token.Length);
+				previousStart = token.Start;
+				MaybeFlush();
+			}
+		}
+		else
+		{
+			for (auto& token : tokens)
+			{
+				WriteTokenText(token, source);
+				MaybeFlush();
+			}
+		}
+
+		if (m_File)
+			Flush();
+	}
+
+	bool Dumper::BinaryToText(Utils::View<std::uint8_t> dump, std::string_view source)
+	{
+		const std::uint8_t* data = dump.begin();
+		const std::uint8_t* end  = dump.end();
+		if (data == end)
+			return false;
+
+		// Dumps accumulated in one Output() follow each other, each one ends at its end marker or after its token count
+		while (data != end)
+		{
+			if (end - data < 5 || data[4] != c_DumpVersion)
+				return false;
+
+			bool isAST = std::memcmp(data, c_ASTMagic, 4) == 0;
+			if (!isAST && std::memcmp(data, c_TokenMagic, 4) != 0)
+				return false;
+			data += 5;
+
+			// Token dumps are counted, AST dumps run up to the end marker
+			std::uint64_t count = ~0ULL;
+			if (!isAST && !ReadVarU64(data, end, count))
+				return false;
+
+			std::uint64_t previousStart = 0;
+			std::uint64_t previousDepth = 0;
+			for (std::uint64_t i = 0; i < count; ++i)
+			{
+				std::uint64_t clazz = 0, depth = 0, length = 0, value = 0;
+				std::int64_t  delta = 0;
+				if (!ReadVarU64(data, end, clazz))
+					return false;
+				if (isAST && clazz == c_ASTEnd)
+					break;
+				if ((isAST && !ReadVarU64(data, end, depth)) ||
+					!ReadVarI64(data, end, delta) ||
+					!ReadVarU64(data, end, length))
+					return false;
+
+				Tokenizer::Token token { .Class = Tokenizer::ETokenClass::Unknown, .Length = static_cast<std::uint32_t>(length), .Start = previousStart + static_cast<std::uint64_t>(delta) };
+				previousStart = token.Start;
+				if (!isAST)
+				{
+					if (clazz > static_cast<std::uint64_t>(Tokenizer::ETokenClass::MultilineComment))
+						return false;
+					token.Class = static_cast<Tokenizer::ETokenClass>(clazz);
+					WriteTokenText(token, source);
+					MaybeFlush();
+					continue;
+				}
+
+				// In pre-order the first node is the root and every other one is at most one deeper than the one before
+				if (clazz >= c_TypeCount || depth > (i == 0 ? 0 : previousDepth + 1))
+					return false;
+				previousDepth = depth;
+
+				EType type = static_cast<EType>(clazz);
+				if (type == EType::FloatLiteral)
+				{
+					if (end - data < 8)
+						return false;
+					for (std::size_t j = 0; j < 8; ++j)
+						value |= static_cast<std::uint64_t>(*data++) << (j * 8);
+				}
+				else if (HasValue(type) && !ReadVarU64(data, end, value))
+				{
+					return false;
+				}
+				WriteNodeText(depth, type, token, value, source);
+				MaybeFlush();
+			}
+		}
+
+		if (m_File)
+			Flush();
+		return true;
+	}
+
+	void Dumper::Flush()
+	{
+		if (!m_File)
+			return;
+		std::fwrite(m_Buffer.data(), 1, m_Buffer.size(), m_File);
+		m_Buffer.clear();
+	}
+
+	void Dumper::WriteNodeText(std::size_t depth, EType type, Tokenizer::Token token, std::uint64_t value, std::string_view source)
+	{
+		for (std::size_t indent = depth * 2; indent;)
+		{
+			std::size_t count = indent < c_Indent.size() ? indent : c_Indent.size();
+			m_Buffer.append(c_Indent.data(), c_Indent.data() + count);
+			indent -= count;
+		}
+
+		std::string_view name = TypeToString(type);
+		m_Buffer.append(name.data(), name.data() + name.size());
+		fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("({} -> {}): '"), token.Start, token.Start + token.Length);
+		WriteEscaped(SourceOf(source, token));
+		switch (type)
+		{
+		case EType::IntegerLiteral: fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("' [{}]\n"), value); break;
+		case EType::FloatLiteral: fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("' [{}]\n"), std::bit_cast<double>(value)); break;
+		case EType::BoolLiteral: fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("' [{}]\n"), value != 0); break;
+		case EType::BinaryExpression:
+		case EType::UnaryExpression:
+			fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("' [{}]\n"), OperatorToString(static_cast<EOperator>(value)));
+			break;
+		default: m_Buffer.append(std::string_view { "'\n" }); break;
+		}
+	}
+
+	void Dumper::WriteNodeBinary(std::size_t depth, EType type, Tokenizer::Token token, std::uint64_t value, std::uint64_t& previousStart)
+	{
+		WriteVarU64(static_cast<std::uint64_t>(type));
+		WriteVarU64(depth);
+		WriteVarI64(static_cast<std::int64_t>(token.Start - previousStart));
+		WriteVarU64(token.Length);
+		previousStart = token.Start;
+		if (type == EType::FloatLiteral)
+		{
+			for (std::size_t i = 0; i < 8; ++i)
+				WriteU8(static_cast<std::uint8_t>(value >> (i * 8)));
+		}
+		else if (HasValue(type))
+		{
+			WriteVarU64(value);
+		}
+	}
+
+	void Dumper::WriteTokenText(Tokenizer::Token token, std::string_view source)
+	{
+		std::string_view name = Tokenizer::TokenClassToString(token.Class);
+		m_Buffer.append(name.data(), name.data() + name.size());
+		fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("({} -> {}): '"), token.Start, token.Start + token.Length);
+		WriteEscaped(SourceOf(source, token));
+		m_Buffer.append(std::string_view { "'\n" });
+	}
+
+	void Dumper::WriteEscaped(std::string_view text)
+	{
+		// Unescaped runs are copied in one go, only the escaped characters are written one by one
+		const char* run = text.data();
+		const char* end = text.data() + text.size();
+		for (const char* c = run; c != end; ++c)
+		{
+			char escape;
+			switch (*c)
+			{
+			case '\'': escape = '\''; break;
+			case '\\': escape = '\\'; break;
+			case '\n': escape = 'n'; break;
+			case '\r': escape = 'r'; break;
+			case '\t': escape = 't'; break;
+			default:
+				if (static_cast<unsigned char>(*c) >= 0x20 && *c != 0x7F)
+					continue;
+				m_Buffer.append(run, c);
+				fmt::format_to(fmt::appender(m_Buffer), FMT_COMPILE("\\x{:02X}"), static_cast<unsigned char>(*c));
+				run = c + 1;
+				continue;
+			}
+			m_Buffer.append(run, c);
+			m_Buffer.push_back('\\');
+			m_Buffer.push_back(escape);
+			run = c + 1;
+		}
+		m_Buffer.append(run, end);
+	}
+
+	void Dumper::WriteVarU64(std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			m_Buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		m_Buffer.push_back(static_cast<char>(value));
+	}
+
+	void Dumper::WriteVarI64(std::int64_t value)
+	{
+		WriteVarU64((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+	}
+} // namespace Frertex::AST
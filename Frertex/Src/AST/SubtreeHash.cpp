@@ -0,0 +1,75 @@
+#include "Frertex/AST/SubtreeHash.h"
+#include "Frertex/Utils/Hash.h"
+
+#include <algorithm>
+
+namespace Frertex::AST
+{
+	void SubtreeHashes::Compute(const AST& ast, std::string_view source, Utils::View<Tokenizer::Token> tokens)
+	{
+		m_Hashes.clear();
+		m_Canonical.clear();
+		std::uint64_t root = ast.RootNode();
+		if (root == ~0ULL)
+			return;
+
+		// Post-order without a stack by following Parent links back up, every node is hashed right after its last child.
+		// Equal subtrees never nest, so the first one finished is also the first one in source order.
+		std::uint64_t node = root;
+		while (true)
+		{
+			while (ast[node].Child != ~0ULL)
+				node = ast[node].Child;
+
+			while (true)
+			{
+				HashNode(ast, node, source, tokens);
+				if (node == root)
+					return;
+				if (ast[node].NextSibling != ~0ULL)
+				{
+					node = ast[node].NextSibling;
+					break;
+				}
+				node = ast[node].Parent;
+			}
+		}
+	}
+
+	void SubtreeHashes::HashNode(const AST& ast, std::uint64_t node, std::string_view source, Utils::View<Tokenizer::Token> tokens)
+	{
+		const Node& value = ast[node];
+
+		std::uint64_t hash = Utils::HashMix(static_cast<std::uint64_t>(value.Type) + 1);
+		hash               = Utils::HashString(source.substr(value.Token.Start, value.Token.Length), hash);
+		if (value.Type == EType::LazyCompoundStatement)
+		{
+			TokenRange range = ast.TokenRangeOf(node);
+			if (range.Count != 0 && range.First + range.Count <= tokens.size())
+			{
+				for (std::uint64_t i = range.First; i < range.First + range.Count; ++i)
+					hash = Utils::HashString(source.substr(tokens[i].Start, tokens[i].Length), Utils::HashCombine(hash, static_cast<std::uint64_t>(tokens[i].Class)));
+			}
+			else
+			{
+				hash = Utils::HashCombine(hash, node);
+			}
+		}
+
+		std::uint64_t children = 0;
+		for (std::uint64_t child = value.Child; child != ~0ULL; child = ast[child].NextSibling, ++children)
+			hash = Utils::HashCombine(hash, m_Hashes[child]);
+		hash = Utils::HashCombine(hash, children);
+
+		if (node >= m_Hashes.size())
+			m_Hashes.resize(std::max<std::uint64_t>(node + 1, m_Hashes.size() * 2));
+		m_Hashes[node] = hash;
+		m_Canonical.try_emplace(hash, node);
+	}
+
+	std::uint64_t SubtreeHashes::CanonicalNode(std::uint64_t hash) const
+	{
+		auto itr = m_Canonical.find(hash);
+		return itr != m_Canonical.end() ? itr->second : ~0ULL;
+	}
+} // namespace Frertex::AST
@@ -0,0 +1,254 @@
+#include "Frertex/Cache/Cache.h"
+#include "Frertex/Tokenizer/Tokenizer.h"
+#include "Frertex/Utils/Hash.h"
+
+#include <Build.h>
+
+#if BUILD_IS_SYSTEM_WINDOWS
+	#include <Windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+namespace Frertex::Cache
+{
+	Key MakeKey(std::string_view source, const Compiler::CompileOptions& options)
+	{
+		// Two differently seeded hashes of the same bytes, names are hashed with their length so no two option lists hash the same bytes
+		Key key {
+			.Low  = Utils::HashString(source, 0x4652'4552'5445'5831ULL),
+			.High = Utils::HashString(source, 0x4649'4C43'4143'4845ULL)
+		};
+		std::uint64_t version = static_cast<std::uint64_t>(Compiler::c_Version) << 32 | FIL::c_Version;
+		key.Low               = Utils::HashCombine(key.Low, version);
+		key.High              = Utils::HashCombine(key.High, version);
+		key.Low               = Utils::HashCombine(key.Low, options.Entrypoints.size());
+		key.High              = Utils::HashCombine(key.High, options.Entrypoints.size());
+		for (std::string_view name : options.Entrypoints)
+		{
+			key.Low  = Utils::HashString(name, key.Low);
+			key.High = Utils::HashString(name, key.High);
+		}
+		return key;
+	}
+
+	MappedFile::MappedFile(MappedFile&& move) noexcept
+		: m_Data(move.m_Data),
+		  m_Size(move.m_Size)
+	{
+		move.m_Data = nullptr;
+		move.m_Size = 0;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (!m_Data)
+			return;
+#if BUILD_IS_SYSTEM_WINDOWS
+		UnmapViewOfFile(m_Data);
+#else
+		munmap(const_cast<std::uint8_t*>(m_Data), m_Size);
+#endif
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& move) noexcept
+	{
+		if (this != &move)
+		{
+			this->~MappedFile();
+			m_Data      = move.m_Data;
+			m_Size      = move.m_Size;
+			move.m_Data = nullptr;
+			move.m_Size = 0;
+		}
+		return *this;
+	}
+
+	MappedFile MappedFile::Map(const std::filesystem::path& path)
+	{
+		// The file and mapping handles can go right away, the view keeps the pages alive even if the file gets removed or replaced
+		MappedFile mapped;
+#if BUILD_IS_SYSTEM_WINDOWS
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return {};
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return {};
+		}
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+			return {};
+
+		void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!data)
+			return {};
+		mapped.m_Data = static_cast<const std::uint8_t*>(data);
+		mapped.m_Size = static_cast<std::size_t>(size.QuadPart);
+#else
+		int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			return {};
+
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size == 0)
+		{
+			close(file);
+			return {};
+		}
+		void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (data == MAP_FAILED)
+			return {};
+		mapped.m_Data = static_cast<const std::uint8_t*>(data);
+		mapped.m_Size = static_cast<std::size_t>(info.st_size);
+#endif
+		return mapped;
+	}
+
+	DiskCache::DiskCache(std::filesystem::path directory, std::uint64_t maxBytes)
+		: m_Directory(std::move(directory)),
+		  m_MaxBytes(maxBytes)
+	{
+	}
+
+	MappedFile DiskCache::Find(const Key& key)
+	{
+		std::filesystem::path path = PathOf(key);
+		MappedFile            file = MappedFile::Map(path);
+		if (!file.Valid())
+		{
+			m_Misses.fetch_add(1, std::memory_order_relaxed);
+			return {};
+		}
+
+		// Marks it as recently used for Trim, losing a race with another reader or Trim is harmless
+		std::error_code error;
+		std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+		m_Hits.fetch_add(1, std::memory_order_relaxed);
+		return file;
+	}
+
+	bool DiskCache::Store(const Key& key, const FIL::Binary& binary)
+	{
+		std::vector<std::uint8_t> data;
+		FIL::WriteBinary(binary, data);
+
+		std::error_code error;
+		std::filesystem::create_directories(m_Directory, error);
+		if (error)
+			return false;
+
+		// Unique between threads and processes, so writers of the same key never share a temporary file
+		static std::atomic<std::uint64_t> s_Counter = 0;
+		std::uint64_t                     unique    = Utils::HashCombine(std::random_device {}(), static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+		unique                                      = Utils::HashCombine(unique, std::hash<std::thread::id> {}(std::this_thread::get_id()));
+		unique                                      = Utils::HashCombine(unique, s_Counter.fetch_add(1, std::memory_order_relaxed));
+
+		std::filesystem::path path      = PathOf(key);
+		std::filesystem::path temporary = m_Directory / fmt::format("{:016x}{:016x}.{:016x}.tmp", key.High, key.Low, unique);
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			if (!file.good())
+			{
+				file.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+
+		// Replaces the file atomically, a writer that got there first wrote the same bytes so losing the race is fine
+		std::filesystem::rename(temporary, path, error);
+		if (error)
+		{
+			std::filesystem::remove(temporary, error);
+			return std::filesystem::exists(path, error);
+		}
+		return true;
+	}
+
+	void DiskCache::Trim()
+	{
+		struct Entry
+		{
+		public:
+			std::filesystem::path           Path;
+			std::filesystem::file_time_type Time;
+			std::uint64_t                   Size;
+		};
+
+		std::vector<Entry> entries;
+		std::uint64_t      totalBytes = 0;
+		std::error_code    error;
+		for (std::filesystem::directory_iterator itr { m_Directory, error }; !error && itr != std::filesystem::directory_iterator {}; itr.increment(error))
+		{
+			// Temporary files belong to writers that are still busy
+			if (itr->path().extension() != ".fil")
+				continue;
+
+			// Files removed by someone else in the meantime are skipped
+			std::error_code entryError;
+			std::uint64_t   size = itr->file_size(entryError);
+			auto            time = itr->last_write_time(entryError);
+			if (entryError)
+				continue;
+			entries.push_back({ .Path = itr->path(), .Time = time, .Size = size });
+			totalBytes += size;
+		}
+		if (totalBytes <= m_MaxBytes)
+			return;
+
+		// Least recently used first, mapped files stay readable after being removed on every system that allows removing them
+		std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.Time < rhs.Time; });
+		for (auto& entry : entries)
+		{
+			if (totalBytes <= m_MaxBytes)
+				break;
+			if (std::filesystem::remove(entry.Path, error))
+				totalBytes -= entry.Size;
+		}
+	}
+
+	MappedFile DiskCache::Compile(std::string_view source, const Compiler::CompileOptions& options, Parser::State& parser, Compiler::State& compiler)
+	{
+		Key key = MakeKey(source, options);
+		if (MappedFile file = Find(key); file.Valid())
+			return file;
+
+		std::vector<Tokenizer::Token> tokens;
+		Tokenizer::Tokenize(source.data(), source.size(), tokens);
+		AST::AST    ast = parser.Parse(source, tokens);
+		FIL::Binary binary;
+		compiler.Compile(binary, source, ast, options);
+		if (!Store(key, binary))
+			return {};
+
+		// Mapped before trimming, so even a binary bigger than the cap is returned
+		MappedFile file = MappedFile::Map(PathOf(key));
+		Trim();
+		return file;
+	}
+
+	std::filesystem::path DiskCache::PathOf(const Key& key) const
+	{
+		return m_Directory / fmt::format("{:016x}{:016x}.fil", key.High, key.Low);
+	}
+} // namespace Frertex::Cache
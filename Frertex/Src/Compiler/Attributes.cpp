@@ -0,0 +1,62 @@
+#include "Frertex/Compiler/Compiler.h"
+#include "Frertex/Utils/Lookups.h"
+
+#include <iterator>
+
+namespace Frertex::Compiler
+{
+	const Attribute* State::FindAttribute(std::string_view name)
+	{
+		// In the order of Lookups::c_AttributeNames
+		static constexpr Attribute c_Attributes[] {
+			{ "VertexShader",                 EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::VertexShader)                 },
+			{ "TessellationControlShader",    EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::TessellationControlShader)    },
+			{ "TessellationEvaluationShader", EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::TessellationEvaluationShader) },
+			{ "GeometryShader",               EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::GeometryShader)               },
+			{ "FragmentShader",               EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::FragmentShader)               },
+			{ "ComputeShader",                EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::ComputeShader)                },
+			{ "RayGenShader",                 EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::RayGenShader)                 },
+			{ "AnyHitShader",                 EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::AnyHitShader)                 },
+			{ "ClosestHitShader",             EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::ClosestHitShader)             },
+			{ "MissShader",                   EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::MissShader)                   },
+			{ "IntersectionShader",           EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::IntersectionShader)           },
+			{ "CallableShader",               EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::CallableShader)               },
+			{ "TaskShader",                   EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::TaskShader)                   },
+			{ "MeshShader",                   EAttributeTarget::Function,  0, 0, &State::OnEntrypointAttribute, static_cast<std::uint32_t>(FIL::EEntrypointType::MeshShader)                   },
+			{ "Position",                     EAttributeTarget::Parameter, 0, 0, &State::OnLocationAttribute,   0                                                                             }
+		};
+		static_assert(std::size(c_Attributes) == std::size(Utils::Lookups::c_AttributeNames));
+		static_assert([] {
+			for (std::size_t i = 0; i < std::size(c_Attributes); ++i)
+				if (c_Attributes[i].Name != Utils::Lookups::c_AttributeNames[i])
+					return false;
+			return true;
+		}(),
+					  "Attribute registry is out of order with the generated lookup");
+
+		std::uint32_t index = Utils::Lookups::FindAttribute(name);
+		return index != Utils::Lookups::c_NotFound ? &c_Attributes[index] : nullptr;
+	}
+
+	void State::OnEntrypointAttribute(const Attribute& attribute, std::uint64_t node, [[maybe_unused]] Utils::View<ConstantValue> arguments, AttributeSubject subject)
+	{
+		FunctionDeclaration& declaration = m_FunctionDeclarations[subject.Index];
+		if (declaration.Type != FIL::EEntrypointType::None)
+		{
+			ReportWarning({ &node, &node + 1 }, (*m_AST)[node].Token.Start, "Attribute unused");
+			return;
+		}
+		declaration.Type = static_cast<FIL::EEntrypointType>(attribute.Value);
+	}
+
+	void State::OnLocationAttribute(const Attribute& attribute, std::uint64_t node, [[maybe_unused]] Utils::View<ConstantValue> arguments, AttributeSubject subject)
+	{
+		FunctionDeclaration::Parameter& parameter = m_Parameters[subject.Index];
+		if (parameter.Location != c_InvalidID)
+		{
+			ReportWarning({ &node, &node + 1 }, (*m_AST)[node].Token.Start, "Attribute unused");
+			return;
+		}
+		parameter.Location = m_Symbols.Intern(attribute.Name);
+	}
+} // namespace Frertex::Compiler
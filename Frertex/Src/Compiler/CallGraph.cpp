@@ -0,0 +1,93 @@
+#include "Frertex/Compiler/Compiler.h"
+#include "Frertex/AST/Visitor.h"
+
+namespace Frertex::Compiler
+{
+	std::uint64_t State::FindReachable()
+	{
+		const AST::AST& ast      = *m_AST;
+		bool            filtered = !m_Options.Entrypoints.empty();
+
+		// Function is c_InvalidID until a selected entrypoint reaches the declaration, numbering happens once everything reachable is known
+		static constexpr std::uint32_t c_Reached = 0;
+
+		m_Callees.clear();
+		m_Reached.clear();
+		m_FoundEntrypoints.assign(m_Options.Entrypoints.size(), false);
+		for (std::uint32_t index = 0; index < m_FunctionDeclarations.size(); ++index)
+		{
+			FunctionDeclaration& declaration = m_FunctionDeclarations[index];
+			declaration.Function             = filtered ? c_InvalidID : c_Reached;
+			declaration.Entrypoint           = declaration.Type != FIL::EEntrypointType::None;
+			declaration.FirstCallee          = 0;
+			declaration.CalleeCount          = 0;
+			if (!filtered || !declaration.Entrypoint)
+				continue;
+
+			m_Name.clear();
+			m_Symbols.AppendQualifiedName(declaration.Scope, declaration.Identifier, m_Name);
+			declaration.Entrypoint = false;
+			for (std::size_t i = 0; i < m_Options.Entrypoints.size(); ++i)
+			{
+				if (m_Options.Entrypoints[i] != m_Name)
+					continue;
+				m_FoundEntrypoints[i]  = true;
+				declaration.Entrypoint = true;
+			}
+			if (declaration.Entrypoint)
+			{
+				declaration.Function = c_Reached;
+				m_Reached.push_back(index);
+			}
+		}
+		for (std::size_t i = 0; i < m_Options.Entrypoints.size(); ++i)
+			if (!m_FoundEntrypoints[i])
+				ReportError({}, 0, "Entrypoint not found");
+
+		// Only bodies of reached functions are walked, each one once, calls in nested functions belong to those
+		std::uint32_t caller = 0;
+		AST::TypedVisitor visitor {
+			AST::On<AST::EType::CallExpression>([&]([[maybe_unused]] const AST::AST& ast2, [[maybe_unused]] std::uint64_t node, const AST::Node& value) -> AST::EWalkerResult {
+				const AST::Node& callee   = ast[value.Child];
+				std::uint32_t    function = callee.Type == AST::EType::Identifier ? FindFunction(caller, GetSource(callee.Token)) : c_InvalidID;
+				if (function == c_InvalidID)
+					return AST::EWalkerResult::Continue;
+
+				m_Callees.push_back(function);
+				if (m_FunctionDeclarations[function].Function == c_InvalidID)
+				{
+					m_FunctionDeclarations[function].Function = c_Reached;
+					m_Reached.push_back(function);
+				}
+				return AST::EWalkerResult::Continue;
+			}),
+			AST::On<AST::EType::FunctionDeclaration>([]([[maybe_unused]] const AST::AST& ast2, [[maybe_unused]] std::uint64_t node, [[maybe_unused]] const AST::Node& value) -> AST::EWalkerResult {
+				return AST::EWalkerResult::SkipChild;
+			})
+		};
+		while (filtered && !m_Reached.empty())
+		{
+			caller = m_Reached.back();
+			m_Reached.pop_back();
+
+			FunctionDeclaration& declaration = m_FunctionDeclarations[caller];
+			declaration.FirstCallee          = static_cast<std::uint32_t>(m_Callees.size());
+			std::uint64_t body               = ast.GetChild(declaration.Node, 4);
+			if (body != ~0ULL)
+				visitor.Walk(ast, body);
+			declaration.CalleeCount = static_cast<std::uint32_t>(m_Callees.size() - declaration.FirstCallee);
+		}
+
+		// FIL functions keep declaration order whatever order they were reached in
+		m_CompiledFunctions.clear();
+		for (std::uint32_t index = 0; index < m_FunctionDeclarations.size(); ++index)
+		{
+			FunctionDeclaration& declaration = m_FunctionDeclarations[index];
+			if (declaration.Function == c_InvalidID)
+				continue;
+			declaration.Function = static_cast<std::uint32_t>(m_CompiledFunctions.size());
+			m_CompiledFunctions.push_back(index);
+		}
+		return m_CompiledFunctions.size();
+	}
+} // namespace Frertex::Compiler
@@ -1,19 +1,77 @@
 #include "Frertex/Compiler/Compiler.h"
+#include "Frertex/AST/Visitor.h"
+
+#include <algorithm>
+#include <thread>
 
 namespace Frertex::Compiler
 {
-	FIL::Binary State::Compile(std::string_view source, const AST::AST& ast)
+	State::State()
 	{
-		m_Source = source;
-		m_AST    = &ast;
-		m_FunctionDeclarations.clear();
-
-		FindDeclarations();
+		m_Passes.Add("Declarations", &State::FindDeclarations, EPassResource::AST, EPassResource::Declarations | EPassResource::Symbols);
+		m_Passes.Add("Reachability", &State::FindReachable, EPassResource::AST | EPassResource::Symbols, EPassResource::Declarations);
+		m_Passes.Add("Signatures", &State::ResolveSignatures, EPassResource::AST, EPassResource::Declarations | EPassResource::Symbols | EPassResource::Types);
+		m_Passes.Add("Lower", &State::LowerFunctions, EPassResource::AST | EPassResource::Declarations | EPassResource::Symbols, EPassResource::Types | EPassResource::IR);
+		m_Passes.Add("Fold constants", &State::FoldConstants, EPassResource::Types, EPassResource::IR);
+		m_Passes.Add("Emit code", &State::EmitFunctions, EPassResource::Declarations | EPassResource::Symbols | EPassResource::IR, EPassResource::BinaryCode);
+		m_Passes.Add("Emit types", &State::EmitTypes, EPassResource::Symbols | EPassResource::Types, EPassResource::BinaryTypes);
+		m_Passes.Add("Link types", &State::LinkTypeNames, EPassResource::None, EPassResource::BinaryCode | EPassResource::BinaryTypes);
+	}
 
+	FIL::Binary State::Compile(std::string_view source, const AST::AST& ast, CompileOptions options)
+	{
 		FIL::Binary fil;
+		Compile(fil, source, ast, options);
 		return fil;
 	}
 
+	void State::Compile(FIL::Binary& binary, std::string_view source, const AST::AST& ast, CompileOptions options)
+	{
+		// Functions and entrypoints are resized when emitting, so their parameter lists keep their storage too
+		binary.Types.clear();
+		binary.Constants.clear();
+		binary.Strings.clear();
+		binary.Code.clear();
+
+		m_Source  = source;
+		m_AST     = &ast;
+		m_Binary  = &binary;
+		m_Options = options;
+		// Names and declarations keep their storage between compiles
+		m_Symbols.Clear();
+		m_Types.Clear();
+		m_FunctionDeclarations.clear();
+		m_Parameters.clear();
+		std::fill(m_ScopeFunctions.begin(), m_ScopeFunctions.end(), c_InvalidID);
+
+		m_Passes.Run(*this, m_Stats);
+	}
+
+	void State::RunWorkers(void (State::*work)(CodegenWorker&))
+	{
+		// The calling thread takes the first worker, the others count their allocations themselves so the pass stats cover them
+		AllocationCounter        counter = m_Passes.GetAllocationCounter();
+		std::vector<std::thread> threads;
+		threads.reserve(m_WorkerCount - 1);
+		for (std::size_t i = 1; i < m_WorkerCount; ++i)
+		{
+			threads.emplace_back([this, work, counter, i]() {
+				CodegenWorker& worker = m_Workers[i];
+				std::uint64_t  bytes  = counter ? counter() : 0;
+				(this->*work)(worker);
+				worker.AllocatedBytes = counter ? counter() - bytes : 0;
+			});
+		}
+		(this->*work)(m_Workers[0]);
+		for (auto& thread : threads)
+			thread.join();
+
+		std::uint64_t helperBytes = 0;
+		for (std::size_t i = 1; i < m_WorkerCount; ++i)
+			helperBytes += m_Workers[i].AllocatedBytes;
+		PassManager::AddHelperAllocations(helperBytes);
+	}
+
 	void State::ReportMessage(std::uint8_t messageType, Utils::View<std::uint64_t> nodes, std::uint64_t point, std::string_view message)
 	{
 	}
@@ -31,154 +89,130 @@ namespace Frertex::Compiler
 		return m_Source.substr(token.Start, token.Length);
 	}
 
-	void State::FindDeclarations()
+	std::uint64_t State::FindDeclarations()
 	{
-		std::vector<std::string_view> currentNamespaceStack;
-
-		AST::WalkASTNode(
-			*m_AST,
-			m_AST->RootNode(),
-			[&](const AST::AST& ast, std::uint64_t index, const AST::Node& node) -> AST::EWalkerResult {
-				// Enter node
-				switch (node.Type)
-				{
-				case AST::EType::FunctionDeclaration:
-				{
-					FIL::EEntrypointType type = FIL::EEntrypointType::None;
-					AST::WalkASTNode(
-						ast,
-						ast.GetChild(index, 0),
-						[&](const AST::AST& ast2, std::uint64_t index2, const AST::Node& node2) -> AST::EWalkerResult {
-							switch (node2.Type)
-							{
-							case AST::EType::Attribute:
-							{
-								if (type != FIL::EEntrypointType::None)
-								{
-									ReportWarning({ index2 }, node2.Token.Start, "Attribute unused");
-									break;
-								}
-								FIL::EEntrypointType type2 = FIL::EntrypointTypeFromString(GetSource(node2.Token));
-								if (type2 == FIL::EEntrypointType::None)
-								{
-									ReportWarning({ index2 }, node2.Token.Start, "Attribute unused");
-									break;
-								}
-								type = type2;
-								break;
-							}
-							default: return AST::EWalkerResult::Continue;
-							}
-							return AST::EWalkerResult::SkipChild;
-						});
-
-					std::string returnType = GetTypename(ast.GetChild(index, 1));
-
-					std::string_view identifier = GetSource(node.Token);
-					std::string      fqn;
-					for (auto cn : currentNamespaceStack)
-						(fqn += cn) += "::";
-					fqn += identifier;
-
-					std::vector<FunctionDeclaration::Parameter> parameters;
-					AST::WalkASTNode(
-						ast,
-						ast.GetChild(index, 3),
-						[&](const AST::AST& ast2, std::uint64_t index2, const AST::Node& node2) -> AST::EWalkerResult {
-							switch (node2.Type)
-							{
-							case AST::EType::Parameter:
-							{
-								std::string location;
-								AST::WalkASTNode(
-									ast2,
-									ast2.GetChild(index2, 0),
-									[&](const AST::AST& ast3, std::uint64_t index3, const AST::Node& node3) -> AST::EWalkerResult {
-										switch (node3.Type)
-										{
-										case AST::EType::Attribute:
-										{
-											if (!location.empty())
-											{
-												ReportWarning({ index3 }, node3.Token.Start, "Attribute unused");
-												break;
-											}
-											std::string location2 = GetLocation(GetSource(node3.Token));
-											if (location2.empty())
-											{
-												ReportWarning({ index3 }, node3.Token.Start, "Attribute unused");
-												break;
-											}
-											location = location2;
-											break;
-										}
-										default: return AST::EWalkerResult::Continue;
-										}
-										return AST::EWalkerResult::SkipChild;
-									});
-
-								parameters.emplace_back(FunctionDeclaration::Parameter {
-									.Qualifier  = FIL::TypeQualifierFromString(GetSource(ast2[ast2.GetChild(index2, 1)].Token)),
-									.Type       = GetTypename(ast2.GetChild(index2, 2)),
-									.Identifier = std::string { GetSource(node2.Token) },
-									.Location   = location });
-								return AST::EWalkerResult::SkipChild;
-							}
-							default: return AST::EWalkerResult::Continue;
-							}
-						});
-
-					m_FunctionDeclarations.emplace_back(FunctionDeclaration {
-						.Node               = index,
-						.Type               = type,
-						.Identifier         = std::string { identifier },
-						.FullyQualifiedName = fqn,
-						.ReturnType         = std::string { returnType },
-						.Parameters         = std::move(parameters) });
-					currentNamespaceStack.emplace_back(identifier);
-					return AST::EWalkerResult::Continue;
-				}
-				case AST::EType::Declarations:
-				case AST::EType::CompoundStatement: return AST::EWalkerResult::Continue;
-				default: return AST::EWalkerResult::SkipChild;
-				}
-			},
-			[&](const AST::AST& ast, std::uint64_t index, const AST::Node& node) -> AST::EWalkerResult {
-				// Exit node
-				switch (node.Type)
-				{
-				case AST::EType::FunctionDeclaration:
-					currentNamespaceStack.pop_back();
-					break;
-				}
-				return AST::EWalkerResult::Continue;
-			});
+		// The index is in allocation order, which depends on how the tree was built, declarations are numbered in source order instead.
+		// Names of nested functions come after the name of the function around them, so ordering by name gives pre-order.
+		const AST::AST&            ast   = *m_AST;
+		Utils::View<std::uint64_t> nodes = ast.NodesOfType(AST::EType::FunctionDeclaration);
+		m_DeclarationNodes.assign(nodes.begin(), nodes.end());
+		std::sort(m_DeclarationNodes.begin(), m_DeclarationNodes.end(), [&ast](std::uint64_t lhs, std::uint64_t rhs) {
+			return ast[lhs].Token.Start < ast[rhs].Token.Start;
+		});
+
+		for (std::uint64_t index : m_DeclarationNodes)
+		{
+			const AST::Node&     node        = ast[index];
+			FunctionDeclaration& declaration = m_FunctionDeclarations.emplace_back();
+			declaration.Node                 = index;
+			declaration.Type                 = FIL::EEntrypointType::None;
+			ApplyAttributes(ast.GetChild(index, 0), { .Target = EAttributeTarget::Function, .Index = static_cast<std::uint32_t>(m_FunctionDeclarations.size() - 1) });
+
+			// Enclosing functions act as namespaces
+			m_NamespaceStack.clear();
+			for (std::uint64_t parent = ast[index].Parent; parent != ~0ULL; parent = ast[parent].Parent)
+				if (ast[parent].Type == AST::EType::FunctionDeclaration)
+					m_NamespaceStack.emplace_back(GetSource(ast[parent].Token));
+
+			declaration.Scope = SymbolTable::c_GlobalScope;
+			for (auto itr = m_NamespaceStack.rbegin(); itr != m_NamespaceStack.rend(); ++itr)
+				declaration.Scope = m_Symbols.Scope(declaration.Scope, m_Symbols.Intern(*itr));
+			declaration.Identifier = m_Symbols.Intern(GetSource(node.Token));
+			declaration.Body       = m_Symbols.Scope(declaration.Scope, declaration.Identifier);
+			if (declaration.Body >= m_ScopeFunctions.size())
+				m_ScopeFunctions.resize(std::max<std::size_t>(declaration.Body + 1, m_ScopeFunctions.size() * 2), c_InvalidID);
+			if (m_ScopeFunctions[declaration.Body] == c_InvalidID)
+				m_ScopeFunctions[declaration.Body] = static_cast<std::uint32_t>(m_FunctionDeclarations.size() - 1);
+		}
+		return m_FunctionDeclarations.size();
 	}
 
-	std::string State::GetTypename(std::uint64_t node)
+	std::uint64_t State::ResolveSignatures()
 	{
-		std::string tpn;
-		AST::WalkASTNode(
-			*m_AST,
-			node,
-			[&](const AST::AST& ast, std::uint64_t index, const AST::Node& node2) -> AST::EWalkerResult {
-				switch (node2.Type)
-				{
-				case AST::EType::Identifier:
-					if (!tpn.empty())
-						tpn += "::";
-					tpn += GetSource(node2.Token);
-					return AST::EWalkerResult::SkipChild;
-				default:
-					return AST::EWalkerResult::Continue;
-				}
-			});
-		return tpn;
+		const AST::AST& ast      = *m_AST;
+		std::uint64_t   resolved = 0;
+		for (std::uint32_t index = 0; index < m_FunctionDeclarations.size(); ++index)
+		{
+			FunctionDeclaration& declaration = m_FunctionDeclarations[index];
+			declaration.FirstParameter       = static_cast<std::uint32_t>(m_Parameters.size());
+			declaration.ParameterCount       = 0;
+			if (declaration.Function == c_InvalidID)
+			{
+				declaration.ReturnType = TypeTable::c_Void;
+				continue;
+			}
+
+			declaration.ReturnType = GetType(ast.GetChild(declaration.Node, 1));
+			for (std::uint64_t parameterNode = ast.GetChild(ast.GetChild(declaration.Node, 3), 0); parameterNode != ~0ULL; parameterNode = ast[parameterNode].NextSibling)
+			{
+				auto& parameter    = m_Parameters.emplace_back();
+				parameter.Location = c_InvalidID;
+				ApplyAttributes(ast.GetChild(parameterNode, 0), { .Target = EAttributeTarget::Parameter, .Index = static_cast<std::uint32_t>(m_Parameters.size() - 1) });
+
+				parameter.Qualifier  = FIL::TypeQualifierFromString(GetSource(ast[ast.GetChild(parameterNode, 1)].Token));
+				parameter.Type       = GetType(ast.GetChild(parameterNode, 2));
+				parameter.Identifier = m_Symbols.Intern(GetSource(ast[parameterNode].Token));
+			}
+			declaration.ParameterCount = static_cast<std::uint32_t>(m_Parameters.size() - declaration.FirstParameter);
+			++resolved;
+		}
+		return resolved;
+	}
+
+	TypeID State::GetType(std::uint64_t node)
+	{
+		// Every identifier but the last one names a namespace
+		ScopeID  scope = SymbolTable::c_GlobalScope;
+		SymbolID name  = c_InvalidID;
+
+		AST::TypedVisitor visitor {
+			AST::On<AST::EType::Identifier>([&]([[maybe_unused]] const AST::AST& ast, [[maybe_unused]] std::uint64_t index, const AST::Node& node2) -> AST::EWalkerResult {
+				if (name != c_InvalidID)
+					scope = m_Symbols.Scope(scope, name);
+				name = m_Symbols.Intern(GetSource(node2.Token));
+				return AST::EWalkerResult::SkipChild;
+			})
+		};
+		visitor.Walk(*m_AST, node);
+		if (name == c_InvalidID)
+			return TypeTable::c_Void;
+		return m_Types.FromName(m_Symbols, scope, name);
 	}
 
-	std::string State::GetLocation(std::string_view string)
+	void State::ApplyAttributes(std::uint64_t attributes, AttributeSubject subject)
 	{
-		if (string == "Position") return "Position";
-		return {};
+		const AST::AST& ast = *m_AST;
+		for (std::uint64_t attribute = ast.GetChild(attributes, 0); attribute != ~0ULL; attribute = ast[attribute].NextSibling)
+		{
+			const Attribute* info = FindAttribute(GetSource(ast[attribute].Token));
+			if (!info || !HasTarget(info->Targets, subject.Target))
+			{
+				ReportWarning({ &attribute, &attribute + 1 }, ast[attribute].Token.Start, "Attribute unused");
+				continue;
+			}
+
+			std::uint64_t arguments     = ast.GetChild(attribute, 1);
+			std::size_t   argumentCount = 0;
+			for (std::uint64_t argument = ast.GetChild(arguments, 0); argument != ~0ULL; argument = ast[argument].NextSibling)
+				++argumentCount;
+			if (argumentCount < info->MinArguments || argumentCount > info->MaxArguments)
+			{
+				ReportError({ &attribute, &attribute + 1 }, ast[attribute].Token.Start, "Wrong number of attribute arguments");
+				continue;
+			}
+
+			// Handlers get the values of the arguments
+			bool constant = true;
+			m_AttributeArguments.clear();
+			for (std::uint64_t argument = ast.GetChild(arguments, 0); argument != ~0ULL; argument = ast[argument].NextSibling)
+			{
+				if (EvaluateConstant(ast[argument].Child, m_AttributeArguments.emplace_back()))
+					continue;
+				ReportError({ &argument, &argument + 1 }, ast[argument].Token.Start, "Attribute argument has to be a constant expression");
+				constant = false;
+			}
+			if (constant)
+				(this->*info->Handle)(*info, attribute, m_AttributeArguments, subject);
+		}
 	}
 } // namespace Frertex::Compiler
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "Frertex/Compiler/ConstantTable.h"
+#include "Frertex/Utils/Hash.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Frertex::Compiler
+{
+	static constexpr std::size_t c_InitialConstantSlots = 64;
+
+	FIL::EOpcode UnaryOpcode(AST::EOperator op)
+	{
+		switch (op)
+		{
+		case AST::EOperator::Negate: return FIL::EOpcode::Negate;
+		case AST::EOperator::LogicalNot: return FIL::EOpcode::LogicalNot;
+		case AST::EOperator::BitNot: return FIL::EOpcode::BitNot;
+		default: return FIL::EOpcode::Nop;
+		}
+	}
+
+	FIL::EOpcode BinaryOpcode(AST::EOperator op)
+	{
+		switch (op)
+		{
+		case AST::EOperator::BitOr: return FIL::EOpcode::BitOr;
+		case AST::EOperator::BitXor: return FIL::EOpcode::BitXor;
+		case AST::EOperator::BitAnd: return FIL::EOpcode::BitAnd;
+		case AST::EOperator::Equal: return FIL::EOpcode::Equal;
+		case AST::EOperator::NotEqual: return FIL::EOpcode::NotEqual;
+		case AST::EOperator::Less: return FIL::EOpcode::Less;
+		case AST::EOperator::LessEqual: return FIL::EOpcode::LessEqual;
+		case AST::EOperator::Greater: return FIL::EOpcode::Greater;
+		case AST::EOperator::GreaterEqual: return FIL::EOpcode::GreaterEqual;
+		case AST::EOperator::ShiftLeft: return FIL::EOpcode::ShiftLeft;
+		case AST::EOperator::ShiftRight: return FIL::EOpcode::ShiftRight;
+		case AST::EOperator::Add: return FIL::EOpcode::Add;
+		case AST::EOperator::Subtract: return FIL::EOpcode::Subtract;
+		case AST::EOperator::Multiply: return FIL::EOpcode::Multiply;
+		case AST::EOperator::Divide: return FIL::EOpcode::Divide;
+		case AST::EOperator::Remainder: return FIL::EOpcode::Remainder;
+		default: return FIL::EOpcode::Nop;
+		}
+	}
+
+	static ConstantValue BoolValue(bool value)
+	{
+		return { .Class = FIL::ETypeClass::Bool, .Bits = value ? 1ULL : 0ULL };
+	}
+
+	static ConstantValue IntValue(std::uint64_t bits)
+	{
+		return { .Class = FIL::ETypeClass::Int, .Bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<std::int32_t>(bits))) };
+	}
+
+	static ConstantValue FloatValue(double value)
+	{
+		return { .Class = FIL::ETypeClass::Float, .Bits = std::bit_cast<std::uint64_t>(static_cast<double>(static_cast<float>(value))) };
+	}
+
+	ConstantValue FitToClass(ConstantValue value)
+	{
+		switch (value.Class)
+		{
+		case FIL::ETypeClass::Bool: return BoolValue(value.Bits != 0);
+		case FIL::ETypeClass::Int: return IntValue(value.Bits);
+		case FIL::ETypeClass::Float: return FloatValue(std::bit_cast<double>(value.Bits));
+		default: return value;
+		}
+	}
+
+	bool FoldUnary(FIL::EOpcode opcode, ConstantValue operand, ConstantValue& result)
+	{
+		operand = FitToClass(operand);
+		switch (opcode)
+		{
+		case FIL::EOpcode::Negate:
+			if (operand.Class == FIL::ETypeClass::Int)
+				result = IntValue(0 - operand.Bits);
+			else if (operand.Class == FIL::ETypeClass::Float)
+				result = FloatValue(-std::bit_cast<double>(operand.Bits));
+			else
+				return false;
+			return true;
+		case FIL::EOpcode::LogicalNot:
+			if (operand.Class != FIL::ETypeClass::Bool)
+				return false;
+			result = BoolValue(operand.Bits == 0);
+			return true;
+		case FIL::EOpcode::BitNot:
+			if (operand.Class != FIL::ETypeClass::Int)
+				return false;
+			result = IntValue(~operand.Bits);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static bool FoldInt(FIL::EOpcode opcode, std::uint64_t lhs, std::uint64_t rhs, ConstantValue& result)
+	{
+		// Operands are sign extended from 32 bits, so wrapping arithmetic is done unsigned at 64 bits and truncated, comparisons, division and right shifts are signed
+		std::int64_t  signedLhs = static_cast<std::int64_t>(lhs);
+		std::int64_t  signedRhs = static_cast<std::int64_t>(rhs);
+		std::uint64_t bits;
+		switch (opcode)
+		{
+		case FIL::EOpcode::BitOr: bits = lhs | rhs; break;
+		case FIL::EOpcode::BitXor: bits = lhs ^ rhs; break;
+		case FIL::EOpcode::BitAnd: bits = lhs & rhs; break;
+		case FIL::EOpcode::Equal: result = BoolValue(lhs == rhs); return true;
+		case FIL::EOpcode::NotEqual: result = BoolValue(lhs != rhs); return true;
+		case FIL::EOpcode::Less: result = BoolValue(signedLhs < signedRhs); return true;
+		case FIL::EOpcode::LessEqual: result = BoolValue(signedLhs <= signedRhs); return true;
+		case FIL::EOpcode::Greater: result = BoolValue(signedLhs > signedRhs); return true;
+		case FIL::EOpcode::GreaterEqual: result = BoolValue(signedLhs >= signedRhs); return true;
+		case FIL::EOpcode::ShiftLeft:
+			if (rhs >= 32)
+				return false;
+			bits = lhs << rhs;
+			break;
+		case FIL::EOpcode::ShiftRight:
+			if (rhs >= 32)
+				return false;
+			bits = static_cast<std::uint64_t>(signedLhs >> rhs);
+			break;
+		case FIL::EOpcode::Add: bits = lhs + rhs; break;
+		case FIL::EOpcode::Subtract: bits = lhs - rhs; break;
+		case FIL::EOpcode::Multiply: bits = lhs * rhs; break;
+		case FIL::EOpcode::Divide:
+		case FIL::EOpcode::Remainder:
+			if (rhs == 0 || (signedLhs == std::numeric_limits<std::int32_t>::min() && signedRhs == -1))
+				return false;
+			bits = static_cast<std::uint64_t>(opcode == FIL::EOpcode::Divide ? signedLhs / signedRhs : signedLhs % signedRhs);
+			break;
+		default: return false;
+		}
+		result = IntValue(bits);
+		return true;
+	}
+
+	static bool FoldFloat(FIL::EOpcode opcode, double lhs, double rhs, ConstantValue& result)
+	{
+		// Doubles hold every single precision operand exactly and their results round to the same float as single precision operations would
+		switch (opcode)
+		{
+		case FIL::EOpcode::Equal: result = BoolValue(lhs == rhs); return true;
+		case FIL::EOpcode::NotEqual: result = BoolValue(lhs != rhs); return true;
+		case FIL::EOpcode::Less: result = BoolValue(lhs < rhs); return true;
+		case FIL::EOpcode::LessEqual: result = BoolValue(lhs <= rhs); return true;
+		case FIL::EOpcode::Greater: result = BoolValue(lhs > rhs); return true;
+		case FIL::EOpcode::GreaterEqual: result = BoolValue(lhs >= rhs); return true;
+		case FIL::EOpcode::Add: result = FloatValue(lhs + rhs); return true;
+		case FIL::EOpcode::Subtract: result = FloatValue(lhs - rhs); return true;
+		case FIL::EOpcode::Multiply: result = FloatValue(lhs * rhs); return true;
+		case FIL::EOpcode::Divide: result = FloatValue(lhs / rhs); return true;
+		case FIL::EOpcode::Remainder: result = FloatValue(std::fmod(lhs, rhs)); return true;
+		default: return false;
+		}
+	}
+
+	static bool FoldBool(FIL::EOpcode opcode, bool lhs, bool rhs, ConstantValue& result)
+	{
+		switch (opcode)
+		{
+		case FIL::EOpcode::BitOr: result = BoolValue(lhs || rhs); return true;
+		case FIL::EOpcode::BitXor: result = BoolValue(lhs != rhs); return true;
+		case FIL::EOpcode::BitAnd: result = BoolValue(lhs && rhs); return true;
+		case FIL::EOpcode::Equal: result = BoolValue(lhs == rhs); return true;
+		case FIL::EOpcode::NotEqual: result = BoolValue(lhs != rhs); return true;
+		default: return false;
+		}
+	}
+
+	bool FoldBinary(FIL::EOpcode opcode, ConstantValue lhs, ConstantValue rhs, ConstantValue& result)
+	{
+		// There are no implicit conversions to fold through
+		if (lhs.Class != rhs.Class)
+			return false;
+
+		lhs = FitToClass(lhs);
+		rhs = FitToClass(rhs);
+		switch (lhs.Class)
+		{
+		case FIL::ETypeClass::Bool: return FoldBool(opcode, lhs.Bits != 0, rhs.Bits != 0, result);
+		case FIL::ETypeClass::Int: return FoldInt(opcode, lhs.Bits, rhs.Bits, result);
+		case FIL::ETypeClass::Float: return FoldFloat(opcode, std::bit_cast<double>(lhs.Bits), std::bit_cast<double>(rhs.Bits), result);
+		default: return false;
+		}
+	}
+
+	ConstantTable::ConstantTable()
+	{
+		Clear();
+	}
+
+	void ConstantTable::Clear()
+	{
+		m_Constants.clear();
+		if (m_Slots.empty())
+			m_Slots.resize(c_InitialConstantSlots);
+		std::fill(m_Slots.begin(), m_Slots.end(), c_InvalidID);
+	}
+
+	ConstantID ConstantTable::Intern(const Constant& constant)
+	{
+		std::uint64_t hash = Hash(constant);
+		std::size_t   mask = m_Slots.size() - 1;
+		std::size_t   slot = hash & mask;
+		for (; m_Slots[slot] != c_InvalidID; slot = (slot + 1) & mask)
+			if (m_Constants[m_Slots[slot]] == constant)
+				return m_Slots[slot];
+
+		ConstantID id = static_cast<ConstantID>(m_Constants.size());
+		m_Constants.push_back(constant);
+		m_Slots[slot] = id;
+		if (m_Constants.size() * 2 > m_Slots.size())
+			GrowSlots();
+		return id;
+	}
+
+	void ConstantTable::Emit(FIL::Binary& binary) const
+	{
+		binary.Constants.reserve(binary.Constants.size() + m_Constants.size());
+		for (auto& constant : m_Constants)
+			binary.Constants.push_back({ .TypeID = constant.Type, .Value = constant.Bits });
+	}
+
+	std::uint64_t ConstantTable::Hash(const Constant& constant)
+	{
+		return Utils::HashCombine(Utils::HashMix(constant.Type), constant.Bits);
+	}
+
+	void ConstantTable::GrowSlots()
+	{
+		m_Slots.assign(m_Slots.size() * 2, c_InvalidID);
+		std::size_t mask = m_Slots.size() - 1;
+		for (ConstantID id = 0; id < m_Constants.size(); ++id)
+		{
+			std::size_t slot = Hash(m_Constants[id]) & mask;
+			while (m_Slots[slot] != c_InvalidID)
+				slot = (slot + 1) & mask;
+			m_Slots[slot] = id;
+		}
+	}
+} // namespace Frertex::Compiler
@@ -0,0 +1,232 @@
+#include "Frertex/Compiler/Compiler.h"
+#include "Frertex/Utils/Hash.h"
+
+#include <cstring>
+
+#include <algorithm>
+#include <utility>
+
+namespace Frertex::Compiler
+{
+	std::uint64_t State::EmitFunctions()
+	{
+		FIL::Binary& binary = *m_Binary;
+
+		std::uint32_t entrypointCount = 0;
+		for (std::size_t i = 0; i < m_WorkerCount; ++i)
+		{
+			CodegenWorker& worker  = m_Workers[i];
+			worker.FirstEntrypoint = entrypointCount;
+			for (std::uint32_t function = worker.FirstFunction; function < worker.FirstFunction + worker.FunctionCount; ++function)
+				if (m_FunctionDeclarations[m_CompiledFunctions[function]].Entrypoint)
+					++entrypointCount;
+		}
+		binary.Functions.resize(m_CompiledFunctions.size());
+		binary.Entrypoints.resize(entrypointCount);
+
+		// Every worker interned its own constants, going through them in order numbers the ones still used just like a single worker would
+		m_Constants.Clear();
+		for (std::size_t i = 0; i < m_WorkerCount; ++i)
+		{
+			CodegenWorker& worker = m_Workers[i];
+			worker.ConstantIDs.assign(worker.Constants.Size(), c_InvalidID);
+			for (IR::Ref instruction = 0; instruction < worker.IR.InstructionCount(); ++instruction)
+			{
+				if (worker.IR[instruction].Opcode != FIL::EOpcode::Constant)
+					continue;
+				ConstantID local = worker.IR.Operands(instruction)[0];
+				if (worker.ConstantIDs[local] == c_InvalidID)
+					worker.ConstantIDs[local] = m_Constants.Intern(worker.Constants[local]);
+			}
+		}
+		m_Constants.Emit(binary);
+
+		// The first worker emits straight into the binary, which is empty at this point, so its offsets already are the final ones
+		std::swap(binary.Code, m_Workers[0].Code);
+		std::swap(binary.Strings, m_Workers[0].Strings);
+		RunWorkers(&State::EmitRange);
+		std::swap(binary.Code, m_Workers[0].Code);
+		std::swap(binary.Strings, m_Workers[0].Strings);
+
+		// Workers hold contiguous ranges in declaration order, so going through them in order lays out unique code and names just like a single worker would.
+		// Those of the first worker already sit at the start of the binary and are compacted in place, those of the rest are appended.
+		std::size_t slotCount = 16;
+		while (slotCount < binary.Functions.size() * 2)
+			slotCount *= 2;
+		m_CodeSlots.assign(slotCount, c_InvalidID);
+		m_NameSlots.assign(slotCount, c_InvalidID);
+
+		std::uint64_t codeSize   = 0;
+		std::uint64_t stringSize = 0;
+		std::uint32_t entrypoint = 0;
+		for (std::size_t i = 0; i < m_WorkerCount; ++i)
+		{
+			const CodegenWorker& worker = m_Workers[i];
+			for (std::uint32_t local = 0; local < worker.FunctionCount; ++local)
+			{
+				std::uint32_t        function = worker.FirstFunction + local;
+				FIL::Function&       out      = binary.Functions[function];
+				const std::uint32_t* code     = (i == 0 ? binary.Code.data() : worker.Code.data()) + out.CodeOffset;
+				const std::uint8_t*  name     = (i == 0 ? binary.Strings.data() : worker.Strings.data()) + out.NameOffset;
+
+				if (std::uint32_t same = FindSameCode(function, code, worker.CodeHashes[local]); same != c_InvalidID)
+				{
+					out.CodeOffset = binary.Functions[same].CodeOffset;
+				}
+				else
+				{
+					if (i == 0)
+						std::memmove(binary.Code.data() + codeSize, code, out.CodeLength * sizeof(std::uint32_t));
+					else
+						binary.Code.insert(binary.Code.end(), code, code + out.CodeLength);
+					out.CodeOffset  = codeSize;
+					codeSize       += out.CodeLength;
+				}
+
+				if (std::uint32_t same = FindSameName(function, name, worker.NameHashes[local]); same != c_InvalidID)
+				{
+					out.NameOffset = binary.Functions[same].NameOffset;
+				}
+				else
+				{
+					if (i == 0)
+						std::memmove(binary.Strings.data() + stringSize, name, out.NameLength);
+					else
+						binary.Strings.insert(binary.Strings.end(), name, name + out.NameLength);
+					out.NameOffset  = stringSize;
+					stringSize     += out.NameLength;
+				}
+
+				if (m_FunctionDeclarations[m_CompiledFunctions[function]].Entrypoint)
+				{
+					binary.Entrypoints[entrypoint].CodeOffset = out.CodeOffset;
+					binary.Entrypoints[entrypoint].NameOffset = out.NameOffset;
+					++entrypoint;
+				}
+			}
+			if (i == 0)
+			{
+				binary.Code.resize(codeSize);
+				binary.Strings.resize(stringSize);
+			}
+		}
+		return binary.Code.size();
+	}
+
+	void State::EmitRange(CodegenWorker& worker)
+	{
+		FIL::Binary& binary = *m_Binary;
+		worker.Code.clear();
+		worker.Strings.clear();
+		worker.CodeHashes.clear();
+		worker.NameHashes.clear();
+
+		std::size_t entrypointIndex = worker.FirstEntrypoint;
+		for (std::uint32_t function = 0; function < worker.FunctionCount; ++function)
+		{
+			const FunctionDeclaration& declaration = m_FunctionDeclarations[worker.IR.GetFunction(function).Declaration];
+			FIL::Function&             out         = binary.Functions[worker.FirstFunction + function];
+
+			out.CodeOffset = worker.Code.size();
+			worker.IR.Emit(function, worker.Code, worker.ConstantIDs);
+			out.CodeLength = worker.Code.size() - out.CodeOffset;
+
+			worker.Name.clear();
+			m_Symbols.AppendQualifiedName(declaration.Scope, declaration.Identifier, worker.Name);
+			out.NameOffset = worker.Strings.size();
+			out.NameLength = worker.Name.size();
+			worker.Strings.insert(worker.Strings.end(), worker.Name.begin(), worker.Name.end());
+
+			out.ReturnTypeID = declaration.ReturnType;
+			out.Parameters.resize(declaration.ParameterCount);
+			for (std::uint32_t i = 0; i < declaration.ParameterCount; ++i)
+			{
+				const FunctionDeclaration::Parameter& parameter = GetParameter(declaration, i);
+				out.Parameters[i]                               = { .Qualifier = parameter.Qualifier, .TypeID = parameter.Type };
+			}
+
+			std::uint64_t signature = Utils::HashCombine(out.ReturnTypeID, out.Parameters.size());
+			for (auto& parameter : out.Parameters)
+				signature = Utils::HashCombine(signature, static_cast<std::uint64_t>(parameter.Qualifier) << 56 | parameter.TypeID);
+			worker.CodeHashes.push_back(Utils::HashBytes(worker.Code.data() + out.CodeOffset, out.CodeLength * sizeof(std::uint32_t), signature));
+			worker.NameHashes.push_back(Utils::HashString(worker.Name));
+
+			if (!declaration.Entrypoint)
+				continue;
+
+			// Entrypoints share the code and name of their function, inputs and outputs get locations in parameter order
+			FIL::Entrypoint& entrypoint = binary.Entrypoints[entrypointIndex++];
+			entrypoint.Type             = declaration.Type;
+			entrypoint.CodeOffset       = out.CodeOffset;
+			entrypoint.CodeLength       = out.CodeLength;
+			entrypoint.NameOffset       = out.NameOffset;
+			entrypoint.NameLength       = out.NameLength;
+			entrypoint.Inputs.clear();
+			entrypoint.Outputs.clear();
+			for (std::uint32_t i = 0; i < declaration.ParameterCount; ++i)
+			{
+				const FunctionDeclaration::Parameter& parameter = GetParameter(declaration, i);
+				if (parameter.Qualifier != FIL::ETypeQualifier::Out)
+					entrypoint.Inputs.push_back({ .Location = entrypoint.Inputs.size(), .TypeID = parameter.Type });
+				if (parameter.Qualifier == FIL::ETypeQualifier::Out || parameter.Qualifier == FIL::ETypeQualifier::InOut)
+					entrypoint.Outputs.push_back({ .Location = entrypoint.Outputs.size(), .TypeID = parameter.Type });
+			}
+		}
+	}
+
+	std::uint32_t State::FindSameCode(std::uint32_t function, const std::uint32_t* code, std::uint64_t hash)
+	{
+		const FIL::Binary&   binary = *m_Binary;
+		const FIL::Function& value  = binary.Functions[function];
+		std::size_t          mask   = m_CodeSlots.size() - 1;
+		std::size_t          slot   = hash & mask;
+		for (; m_CodeSlots[slot] != c_InvalidID; slot = (slot + 1) & mask)
+		{
+			const FIL::Function& other = binary.Functions[m_CodeSlots[slot]];
+			if (other.CodeLength == value.CodeLength && other.ReturnTypeID == value.ReturnTypeID && other.Parameters == value.Parameters &&
+				std::equal(code, code + value.CodeLength, binary.Code.data() + other.CodeOffset))
+				return m_CodeSlots[slot];
+		}
+		m_CodeSlots[slot] = function;
+		return c_InvalidID;
+	}
+
+	std::uint32_t State::FindSameName(std::uint32_t function, const std::uint8_t* name, std::uint64_t hash)
+	{
+		const FIL::Binary&   binary = *m_Binary;
+		const FIL::Function& value  = binary.Functions[function];
+		std::size_t          mask   = m_NameSlots.size() - 1;
+		std::size_t          slot   = hash & mask;
+		for (; m_NameSlots[slot] != c_InvalidID; slot = (slot + 1) & mask)
+		{
+			const FIL::Function& other = binary.Functions[m_NameSlots[slot]];
+			if (other.NameLength == value.NameLength && std::equal(name, name + value.NameLength, binary.Strings.data() + other.NameOffset))
+				return m_NameSlots[slot];
+		}
+		m_NameSlots[slot] = function;
+		return c_InvalidID;
+	}
+
+	std::uint64_t State::EmitTypes()
+	{
+		m_TypeNames.clear();
+		m_Types.Emit(m_Symbols, m_Binary->Types, m_TypeNames);
+		return m_Types.Size();
+	}
+
+	std::uint64_t State::LinkTypeNames()
+	{
+		FIL::Binary&  binary = *m_Binary;
+		std::uint64_t offset = binary.Strings.size();
+		std::uint64_t linked = 0;
+		binary.Strings.insert(binary.Strings.end(), m_TypeNames.begin(), m_TypeNames.end());
+		for (auto& type : binary.Types)
+		{
+			if (type.Class != FIL::ETypeClass::Named)
+				continue;
+			type.NameOffset += offset;
+			++linked;
+		}
+		return linked;
+	}
+} // namespace Frertex::Compiler
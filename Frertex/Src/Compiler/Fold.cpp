@@ -0,0 +1,133 @@
+#include "Frertex/Compiler/Compiler.h"
+
+#include <bit>
+
+namespace Frertex::Compiler
+{
+	std::uint64_t State::FoldConstants()
+	{
+		RunWorkers(&State::FoldRange);
+
+		std::uint64_t folded = 0;
+		for (std::size_t i = 0; i < m_WorkerCount; ++i)
+			folded += m_Workers[i].Folded;
+		return folded;
+	}
+
+	void State::FoldRange(CodegenWorker& worker)
+	{
+		// Operands come before their users in every block and phis are never folded, so one pass in order folds whole chains of operations
+		IR::Module& ir = worker.IR;
+		worker.Folded  = 0;
+		for (IR::Ref instruction = 0; instruction < ir.InstructionCount(); ++instruction)
+		{
+			FIL::EOpcode opcode = ir[instruction].Opcode;
+			bool         unary  = opcode >= FIL::EOpcode::Negate && opcode <= FIL::EOpcode::BitNot;
+			bool         binary = opcode >= FIL::EOpcode::BitOr && opcode <= FIL::EOpcode::Remainder;
+			if (!unary && !binary)
+				continue;
+
+			Utils::View<std::uint32_t> operands = ir.Operands(instruction);
+			ConstantValue              lhs;
+			ConstantValue              rhs;
+			ConstantValue              result;
+			if (!ConstantOf(worker, operands[0], lhs) || (binary && !ConstantOf(worker, operands[1], rhs)))
+				continue;
+			if (unary ? !FoldUnary(opcode, lhs, result) : !FoldBinary(opcode, lhs, rhs, result))
+				continue;
+
+			ir.SetConstant(instruction, worker.Constants.Intern({ .Type = ir[instruction].Type, .Bits = result.Bits }));
+			++worker.Folded;
+		}
+
+		// Literals folded into other constants are left without uses
+		for (IR::Ref instruction = 0; instruction < ir.InstructionCount(); ++instruction)
+			if (ir[instruction].Opcode == FIL::EOpcode::Constant && ir[instruction].FirstUse == IR::c_NoRef)
+				ir.Remove(instruction);
+	}
+
+	bool State::ConstantOf(const CodegenWorker& worker, IR::Ref value, ConstantValue& result) const
+	{
+		if (value == IR::c_NoRef || worker.IR[value].Opcode != FIL::EOpcode::Constant)
+			return false;
+
+		const Constant& constant = worker.Constants[worker.IR.Operands(value)[0]];
+		result                   = { .Class = m_Types[constant.Type].Class, .Bits = constant.Bits };
+		return true;
+	}
+
+	bool State::EvaluateConstant(std::uint64_t root, ConstantValue& result)
+	{
+		// Post-order over explicit stacks like LowerExpression
+		const AST::AST& ast = *m_AST;
+		m_EvaluateFrames.clear();
+		m_EvaluateValues.clear();
+		m_EvaluateFrames.push_back({ .Node = root });
+		while (!m_EvaluateFrames.empty())
+		{
+			LowerFrame frame = m_EvaluateFrames.back();
+			m_EvaluateFrames.pop_back();
+			if (frame.Node == ~0ULL)
+				return false;
+
+			const AST::Node& node = ast[frame.Node];
+			switch (node.Type)
+			{
+			case AST::EType::IntegerLiteral:
+				m_EvaluateValues.push_back(FitToClass({ .Class = FIL::ETypeClass::Int, .Bits = ast.IntegerValue(frame.Node) }));
+				break;
+			case AST::EType::FloatLiteral:
+				m_EvaluateValues.push_back(FitToClass({ .Class = FIL::ETypeClass::Float, .Bits = std::bit_cast<std::uint64_t>(ast.FloatValue(frame.Node)) }));
+				break;
+			case AST::EType::BoolLiteral:
+				m_EvaluateValues.push_back({ .Class = FIL::ETypeClass::Bool, .Bits = ast.BoolValue(frame.Node) ? 1ULL : 0ULL });
+				break;
+			case AST::EType::UnaryExpression:
+			{
+				if (frame.Stage == 0)
+				{
+					m_EvaluateFrames.push_back({ .Node = frame.Node, .Stage = 1 });
+					m_EvaluateFrames.push_back({ .Node = node.Child });
+					break;
+				}
+
+				// Unary plus is the operand itself
+				AST::EOperator op = ast.Operator(frame.Node);
+				if (op != AST::EOperator::Plus && !FoldUnary(UnaryOpcode(op), m_EvaluateValues.back(), m_EvaluateValues.back()))
+					return false;
+				break;
+			}
+			case AST::EType::BinaryExpression:
+			{
+				if (frame.Stage == 0)
+				{
+					m_EvaluateFrames.push_back({ .Node = frame.Node, .Stage = 1 });
+					m_EvaluateFrames.push_back({ .Node = ast[node.Child].NextSibling });
+					m_EvaluateFrames.push_back({ .Node = node.Child });
+					break;
+				}
+
+				// Without side effects short circuiting makes no difference, so && and || are & and | on bools
+				AST::EOperator op     = ast.Operator(frame.Node);
+				FIL::EOpcode   opcode = BinaryOpcode(op);
+				ConstantValue  rhs    = m_EvaluateValues.back();
+				m_EvaluateValues.pop_back();
+				ConstantValue& lhs = m_EvaluateValues.back();
+				if (op == AST::EOperator::LogicalAnd || op == AST::EOperator::LogicalOr)
+				{
+					if (lhs.Class != FIL::ETypeClass::Bool)
+						return false;
+					opcode = op == AST::EOperator::LogicalAnd ? FIL::EOpcode::BitAnd : FIL::EOpcode::BitOr;
+				}
+				if (!FoldBinary(opcode, lhs, rhs, lhs))
+					return false;
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		result = m_EvaluateValues.back();
+		return true;
+	}
+} // namespace Frertex::Compiler
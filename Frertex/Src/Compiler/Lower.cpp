@@ -0,0 +1,331 @@
+#include "Frertex/Compiler/Compiler.h"
+#include "Frertex/AST/Visitor.h"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace Frertex::Compiler
+{
+	static bool IsComparison(FIL::EOpcode opcode)
+	{
+		return opcode >= FIL::EOpcode::Equal && opcode <= FIL::EOpcode::GreaterEqual;
+	}
+
+	std::uint64_t State::LowerFunctions()
+	{
+		m_BoolType  = m_Types.Intern({ .Class = FIL::ETypeClass::Bool, .Rows = 1, .Columns = 1, .Scope = c_InvalidID, .Name = c_InvalidID });
+		m_IntType   = m_Types.Intern({ .Class = FIL::ETypeClass::Int, .Rows = 1, .Columns = 1, .Scope = c_InvalidID, .Name = c_InvalidID });
+		m_FloatType = m_Types.Intern({ .Class = FIL::ETypeClass::Float, .Rows = 1, .Columns = 1, .Scope = c_InvalidID, .Name = c_InvalidID });
+
+		// Contiguous ranges in declaration order, so appending the output of the workers in order gives the same binary as a single worker
+		std::size_t functionCount = m_CompiledFunctions.size();
+		std::size_t threads       = m_CodegenThreads ? m_CodegenThreads : std::max(std::thread::hardware_concurrency(), 1U);
+		m_WorkerCount             = std::clamp<std::size_t>((functionCount + c_MinFunctionsPerWorker - 1) / c_MinFunctionsPerWorker, 1, threads);
+		if (m_Workers.size() < m_WorkerCount)
+			m_Workers.resize(m_WorkerCount);
+		for (std::size_t i = 0; i < m_WorkerCount; ++i)
+		{
+			m_Workers[i].FirstFunction = static_cast<std::uint32_t>(functionCount * i / m_WorkerCount);
+			m_Workers[i].FunctionCount = static_cast<std::uint32_t>(functionCount * (i + 1) / m_WorkerCount) - m_Workers[i].FirstFunction;
+		}
+		RunWorkers(&State::LowerRange);
+
+		std::uint64_t instructions = 0;
+		for (std::size_t i = 0; i < m_WorkerCount; ++i)
+			instructions += m_Workers[i].IR.InstructionCount();
+		return instructions;
+	}
+
+	void State::LowerRange(CodegenWorker& worker)
+	{
+		worker.IR.Clear();
+		worker.Constants.Clear();
+		for (std::uint32_t function = worker.FirstFunction; function < worker.FirstFunction + worker.FunctionCount; ++function)
+			LowerFunction(worker, m_CompiledFunctions[function]);
+	}
+
+	void State::LowerFunction(CodegenWorker& worker, std::uint32_t index)
+	{
+		const AST::AST&            ast         = *m_AST;
+		const FunctionDeclaration& declaration = m_FunctionDeclarations[index];
+		worker.CurrentFunction                 = index;
+
+		worker.IR.BeginFunction(index);
+		worker.IR.BeginBlock();
+
+		// Out parameters start out undefined, everything else starts as the value passed in
+		worker.Variables.clear();
+		for (std::uint32_t i = 0; i < declaration.ParameterCount; ++i)
+		{
+			const FunctionDeclaration::Parameter& parameter = GetParameter(declaration, i);
+			if (parameter.Qualifier == FIL::ETypeQualifier::Out)
+				worker.Variables.push_back(worker.IR.Add(FIL::EOpcode::Undefined, parameter.Type, {}, declaration.Node));
+			else
+				worker.Variables.push_back(worker.IR.Add(FIL::EOpcode::Parameter, parameter.Type, { &i, &i + 1 }, declaration.Node));
+		}
+
+		std::uint64_t body = ast.GetChild(declaration.Node, 4);
+		if (body != ~0ULL && ast[body].Type == AST::EType::LazyCompoundStatement)
+		{
+			ReportError({ &body, &body + 1 }, ast[body].Token.Start, "Function body has to be expanded before compiling");
+		}
+		else if (body != ~0ULL)
+		{
+			// Nested functions are lowered on their own
+			AST::TypedVisitor visitor {
+				AST::On<AST::EType::ExpressionStatement>([&]([[maybe_unused]] const AST::AST& ast2, [[maybe_unused]] std::uint64_t node, const AST::Node& value) -> AST::EWalkerResult {
+					LowerExpression(worker, value.Child);
+					return AST::EWalkerResult::SkipChild;
+				}),
+				AST::On<AST::EType::FunctionDeclaration>([]([[maybe_unused]] const AST::AST& ast2, [[maybe_unused]] std::uint64_t node, [[maybe_unused]] const AST::Node& value) -> AST::EWalkerResult {
+					return AST::EWalkerResult::SkipChild;
+				})
+			};
+			visitor.Walk(ast, body);
+		}
+
+		for (std::uint32_t i = 0; i < declaration.ParameterCount; ++i)
+		{
+			FIL::ETypeQualifier qualifier = GetParameter(declaration, i).Qualifier;
+			if (qualifier == FIL::ETypeQualifier::Out || qualifier == FIL::ETypeQualifier::InOut)
+			{
+				IR::Ref operands[] { i, worker.Variables[i] };
+				worker.IR.Add(FIL::EOpcode::Store, IR::c_NoRef, operands, declaration.Node);
+			}
+		}
+		worker.IR.Add(FIL::EOpcode::Return, IR::c_NoRef, {}, declaration.Node);
+	}
+
+	IR::Ref State::LowerExpression(CodegenWorker& worker, std::uint64_t root)
+	{
+		// Post-order over explicit stacks like the parser builds expressions, so deeply nested expressions cost no recursion
+		const AST::AST& ast       = *m_AST;
+		std::size_t     valueBase = worker.Values.size();
+		worker.LowerFrames.push_back({ .Node = root });
+		while (!worker.LowerFrames.empty())
+		{
+			LowerFrame       frame = worker.LowerFrames.back();
+			const AST::Node& node  = ast[frame.Node];
+			worker.LowerFrames.pop_back();
+
+			switch (node.Type)
+			{
+			case AST::EType::IntegerLiteral:
+				worker.Values.push_back(AddConstant(worker, m_IntType, ast.IntegerValue(frame.Node), frame.Node));
+				break;
+			case AST::EType::FloatLiteral:
+				worker.Values.push_back(AddConstant(worker, m_FloatType, std::bit_cast<std::uint64_t>(ast.FloatValue(frame.Node)), frame.Node));
+				break;
+			case AST::EType::BoolLiteral:
+				worker.Values.push_back(AddConstant(worker, m_BoolType, ast.BoolValue(frame.Node) ? 1 : 0, frame.Node));
+				break;
+			case AST::EType::Identifier:
+				worker.Values.push_back(LowerIdentifier(worker, frame.Node));
+				break;
+			case AST::EType::UnaryExpression:
+			{
+				if (frame.Stage == 0)
+				{
+					worker.LowerFrames.push_back({ .Node = frame.Node, .Stage = 1 });
+					worker.LowerFrames.push_back({ .Node = node.Child });
+					break;
+				}
+
+				IR::Ref operand = worker.Values.back();
+				switch (ast.Operator(frame.Node))
+				{
+				case AST::EOperator::Negate: worker.Values.back() = worker.IR.Add(FIL::EOpcode::Negate, worker.IR[operand].Type, { &operand, &operand + 1 }, frame.Node); break;
+				case AST::EOperator::LogicalNot: worker.Values.back() = worker.IR.Add(FIL::EOpcode::LogicalNot, m_BoolType, { &operand, &operand + 1 }, frame.Node); break;
+				case AST::EOperator::BitNot: worker.Values.back() = worker.IR.Add(FIL::EOpcode::BitNot, worker.IR[operand].Type, { &operand, &operand + 1 }, frame.Node); break;
+				default: break; // Unary plus is the operand itself
+				}
+				break;
+			}
+			case AST::EType::BinaryExpression:
+			{
+				AST::EOperator op  = ast.Operator(frame.Node);
+				std::uint64_t  lhs = node.Child;
+				std::uint64_t  rhs = ast[lhs].NextSibling;
+				if (op == AST::EOperator::Assign)
+				{
+					// Assigning gives the parameter a new SSA value, the value of the expression is the assigned value
+					if (frame.Stage == 0)
+					{
+						worker.LowerFrames.push_back({ .Node = frame.Node, .Stage = 1 });
+						worker.LowerFrames.push_back({ .Node = rhs });
+						break;
+					}
+
+					std::uint32_t parameter = ast[lhs].Type == AST::EType::Identifier ? FindParameter(worker.CurrentFunction, GetSource(ast[lhs].Token)) : c_InvalidID;
+					if (parameter == c_InvalidID)
+						ReportError({ &lhs, &lhs + 1 }, ast[lhs].Token.Start, "Expression is not assignable");
+					else
+						worker.Variables[parameter] = worker.Values.back();
+					break;
+				}
+
+				if (op == AST::EOperator::LogicalAnd || op == AST::EOperator::LogicalOr)
+				{
+					// Short circuiting, the right hand side gets its own block and both paths meet in a block starting with phis for the result and every parameter it assigned
+					bool isAnd = op == AST::EOperator::LogicalAnd;
+					if (frame.Stage == 0)
+					{
+						worker.LowerFrames.push_back({ .Node = frame.Node, .Stage = 1 });
+						worker.LowerFrames.push_back({ .Node = lhs });
+						break;
+					}
+					if (frame.Stage == 1)
+					{
+						frame.Stage        = 2;
+						frame.Value        = worker.Values.back();
+						frame.Block        = worker.IR.CurrentBlock();
+						frame.SnapshotBase = static_cast<std::uint32_t>(worker.VariableSnapshots.size());
+						worker.Values.pop_back();
+						worker.VariableSnapshots.insert(worker.VariableSnapshots.end(), worker.Variables.begin(), worker.Variables.end());
+
+						IR::Ref branchOperands[] { frame.Value, IR::c_NoRef, IR::c_NoRef };
+						frame.Branch     = worker.IR.Add(FIL::EOpcode::BranchConditional, IR::c_NoRef, branchOperands, frame.Node);
+						IR::Ref rhsBlock = worker.IR.BeginBlock();
+						worker.IR.SetOperand(frame.Branch, isAnd ? 1 : 2, rhsBlock);
+						worker.LowerFrames.push_back(frame);
+						worker.LowerFrames.push_back({ .Node = rhs });
+						break;
+					}
+
+					IR::Ref rhsValue = worker.Values.back();
+					IR::Ref rhsBlock = worker.IR.CurrentBlock();
+					IR::Ref jumpOperands[] { IR::c_NoRef };
+					IR::Ref jump = worker.IR.Add(FIL::EOpcode::Branch, IR::c_NoRef, jumpOperands, frame.Node);
+					IR::Ref join = worker.IR.BeginBlock();
+					worker.IR.SetOperand(jump, 0, join);
+					worker.IR.SetOperand(frame.Branch, isAnd ? 2 : 1, join);
+
+					// Skipping the right hand side only happens when the left hand side already is the result
+					IR::Ref resultOperands[] { frame.Value, frame.Block, rhsValue, rhsBlock };
+					worker.Values.back() = worker.IR.Add(FIL::EOpcode::Phi, m_BoolType, resultOperands, frame.Node);
+					for (std::size_t i = 0; i < worker.Variables.size(); ++i)
+					{
+						IR::Ref before = worker.VariableSnapshots[frame.SnapshotBase + i];
+						IR::Ref after  = worker.Variables[i];
+						if (before != after)
+						{
+							IR::Ref phiOperands[] { before, frame.Block, after, rhsBlock };
+							worker.Variables[i] = worker.IR.Add(FIL::EOpcode::Phi, worker.IR[after].Type, phiOperands, frame.Node);
+						}
+					}
+					worker.VariableSnapshots.resize(frame.SnapshotBase);
+					break;
+				}
+
+				if (frame.Stage == 0)
+				{
+					worker.LowerFrames.push_back({ .Node = frame.Node, .Stage = 1 });
+					worker.LowerFrames.push_back({ .Node = rhs });
+					worker.LowerFrames.push_back({ .Node = lhs });
+					break;
+				}
+
+				FIL::EOpcode opcode   = BinaryOpcode(op);
+				IR::Ref      rhsValue = worker.Values.back();
+				worker.Values.pop_back();
+				IR::Ref lhsValue = worker.Values.back();
+				IR::Ref operands[] { lhsValue, rhsValue };
+				worker.Values.back() = worker.IR.Add(opcode, IsComparison(opcode) ? m_BoolType : worker.IR[lhsValue].Type, operands, frame.Node);
+				break;
+			}
+			case AST::EType::CallExpression:
+			{
+				std::uint64_t callee    = node.Child;
+				std::uint64_t arguments = ast[callee].NextSibling;
+				if (frame.Stage == 0)
+				{
+					// Arguments are pushed last to first so they are lowered first to last
+					std::uint64_t last  = ~0ULL;
+					std::uint32_t count = 0;
+					for (std::uint64_t argument = ast.GetChild(arguments, 0); argument != ~0ULL; argument = ast[argument].NextSibling, ++count)
+						last = argument;
+					worker.LowerFrames.push_back({ .Node = frame.Node, .Stage = 1, .Count = count });
+					for (std::uint64_t argument = last; argument != ~0ULL; argument = ast[argument].PreviousSibling)
+						worker.LowerFrames.push_back({ .Node = ast[argument].Child });
+					break;
+				}
+
+				std::uint32_t function = ast[callee].Type == AST::EType::Identifier ? FindFunction(worker.CurrentFunction, GetSource(ast[callee].Token)) : c_InvalidID;
+				std::size_t   first    = worker.Values.size() - frame.Count;
+				if (function == c_InvalidID)
+				{
+					ReportError({ &callee, &callee + 1 }, ast[callee].Token.Start, "Unknown function");
+					worker.Values.resize(first);
+					worker.Values.push_back(worker.IR.Add(FIL::EOpcode::Undefined, TypeTable::c_Void, {}, frame.Node));
+					break;
+				}
+
+				worker.CallOperands.clear();
+				worker.CallOperands.push_back(m_FunctionDeclarations[function].Function);
+				worker.CallOperands.insert(worker.CallOperands.end(), worker.Values.begin() + first, worker.Values.end());
+				worker.Values.resize(first);
+				worker.Values.push_back(worker.IR.Add(FIL::EOpcode::Call, m_FunctionDeclarations[function].ReturnType, { worker.CallOperands.data(), worker.CallOperands.data() + worker.CallOperands.size() }, frame.Node));
+				break;
+			}
+			default:
+				ReportError({ &frame.Node, &frame.Node + 1 }, node.Token.Start, "Expected expression");
+				worker.Values.push_back(worker.IR.Add(FIL::EOpcode::Undefined, TypeTable::c_Void, {}, frame.Node));
+				break;
+			}
+		}
+
+		IR::Ref result = worker.Values.back();
+		worker.Values.resize(valueBase);
+		return result;
+	}
+
+	IR::Ref State::LowerIdentifier(CodegenWorker& worker, std::uint64_t node)
+	{
+		const AST::Node& value     = (*m_AST)[node];
+		std::uint32_t    parameter = FindParameter(worker.CurrentFunction, GetSource(value.Token));
+		if (parameter != c_InvalidID)
+			return worker.Variables[parameter];
+
+		ReportError({ &node, &node + 1 }, value.Token.Start, "Unknown identifier");
+		return worker.IR.Add(FIL::EOpcode::Undefined, TypeTable::c_Void, {}, node);
+	}
+
+	IR::Ref State::AddConstant(CodegenWorker& worker, TypeID type, std::uint64_t bits, std::uint64_t node)
+	{
+		// Literals are parsed at 64 bits, constants hold them at the width of their type
+		ConstantValue value    = FitToClass({ .Class = m_Types[type].Class, .Bits = bits });
+		std::uint32_t constant = worker.Constants.Intern({ .Type = type, .Bits = value.Bits });
+		return worker.IR.Add(FIL::EOpcode::Constant, type, { &constant, &constant + 1 }, node);
+	}
+
+	std::uint32_t State::FindFunction(std::uint32_t caller, std::string_view name) const
+	{
+		// Innermost first, from the functions declared inside the current one out to the global scope
+		SymbolID symbol = m_Symbols.Find(name);
+		if (symbol == c_InvalidID)
+			return c_InvalidID;
+
+		for (ScopeID scope = m_FunctionDeclarations[caller].Body;; scope = m_Symbols.ParentOf(scope))
+		{
+			ScopeID body = m_Symbols.FindScope(scope, symbol);
+			if (body != c_InvalidID && body < m_ScopeFunctions.size() && m_ScopeFunctions[body] != c_InvalidID)
+				return m_ScopeFunctions[body];
+			if (scope == SymbolTable::c_GlobalScope)
+				return c_InvalidID;
+		}
+	}
+
+	std::uint32_t State::FindParameter(std::uint32_t caller, std::string_view name) const
+	{
+		SymbolID symbol = m_Symbols.Find(name);
+		if (symbol == c_InvalidID)
+			return c_InvalidID;
+
+		const FunctionDeclaration& declaration = m_FunctionDeclarations[caller];
+		for (std::uint32_t i = 0; i < declaration.ParameterCount; ++i)
+			if (GetParameter(declaration, i).Identifier == symbol)
+				return i;
+		return c_InvalidID;
+	}
+} // namespace Frertex::Compiler
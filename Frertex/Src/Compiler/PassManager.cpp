@@ -0,0 +1,88 @@
+#include "Frertex/Compiler/PassManager.h"
+#include "Frertex/Compiler/Compiler.h"
+
+#include <chrono>
+#include <thread>
+
+namespace Frertex::Compiler
+{
+	// Helper thread bytes of the pass running on this thread, passes of a wave run on their own threads so each one has its own
+	static thread_local std::uint64_t* t_HelperBytes = nullptr;
+
+	void PassManager::Add(std::string_view name, PassFunction function, EPassResource reads, EPassResource writes)
+	{
+		// Joins the last wave unless it writes something a pass there touches or touches something one of them writes
+		std::uint32_t wave = 0;
+		if (!m_Passes.empty())
+		{
+			wave = m_Passes.back().Wave;
+			for (auto itr = m_Passes.rbegin(); itr != m_Passes.rend() && itr->Wave == wave; ++itr)
+			{
+				if (Overlaps(writes, itr->Reads | itr->Writes) || Overlaps(reads | writes, itr->Writes))
+				{
+					++wave;
+					break;
+				}
+			}
+		}
+		m_Passes.push_back({ .Name = name, .Function = function, .Reads = reads, .Writes = writes, .Wave = wave });
+	}
+
+	void PassManager::Run(State& state, CompileStats& stats) const
+	{
+		using Clock = std::chrono::steady_clock;
+
+		stats.Passes.resize(m_Passes.size());
+		auto start = Clock::now();
+		for (std::size_t first = 0; first < m_Passes.size();)
+		{
+			std::size_t last = first + 1;
+			while (last < m_Passes.size() && m_Passes[last].Wave == m_Passes[first].Wave)
+				++last;
+
+			if (!m_Parallel || last - first == 1)
+			{
+				for (std::size_t i = first; i < last; ++i)
+					RunPass(state, m_Passes[i], stats.Passes[i]);
+			}
+			else
+			{
+				// The calling thread takes the first pass of the wave
+				std::vector<std::thread> threads;
+				threads.reserve(last - first - 1);
+				for (std::size_t i = first + 1; i < last; ++i)
+					threads.emplace_back([this, &state, &stats, i]() { RunPass(state, m_Passes[i], stats.Passes[i]); });
+				RunPass(state, m_Passes[first], stats.Passes[first]);
+				for (auto& thread : threads)
+					thread.join();
+			}
+			first = last;
+		}
+		stats.Nanoseconds = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+	}
+
+	void PassManager::AddHelperAllocations(std::uint64_t bytes)
+	{
+		if (t_HelperBytes)
+			*t_HelperBytes += bytes;
+	}
+
+	void PassManager::RunPass(State& state, const Pass& pass, PassStats& stats) const
+	{
+		using Clock = std::chrono::steady_clock;
+
+		std::uint64_t helperBytes = 0;
+		t_HelperBytes             = &helperBytes;
+		std::uint64_t bytes       = m_AllocationCounter ? m_AllocationCounter() : 0;
+		auto          start       = Clock::now();
+		std::uint64_t items       = (state.*pass.Function)();
+		auto          end         = Clock::now();
+		t_HelperBytes             = nullptr;
+
+		stats.Name           = pass.Name;
+		stats.Wave           = pass.Wave;
+		stats.Nanoseconds    = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		stats.AllocatedBytes = m_AllocationCounter ? m_AllocationCounter() - bytes + helperBytes : 0;
+		stats.Items          = items;
+	}
+} // namespace Frertex::Compiler
@@ -0,0 +1,161 @@
+#include "Frertex/Compiler/SymbolTable.h"
+#include "Frertex/Utils/Hash.h"
+
+#include <algorithm>
+
+namespace Frertex::Compiler
+{
+	static constexpr std::size_t c_InitialSlots = 64;
+
+	SymbolTable::SymbolTable()
+	{
+		Clear();
+	}
+
+	void SymbolTable::Clear()
+	{
+		m_Characters.clear();
+		m_Symbols.clear();
+		m_Scopes.clear();
+		m_Scopes.push_back({ .Parent = c_InvalidID, .Name = c_InvalidID });
+		if (m_SymbolSlots.empty())
+			m_SymbolSlots.resize(c_InitialSlots);
+		if (m_ScopeSlots.empty())
+			m_ScopeSlots.resize(c_InitialSlots);
+		std::fill(m_SymbolSlots.begin(), m_SymbolSlots.end(), c_InvalidID);
+		std::fill(m_ScopeSlots.begin(), m_ScopeSlots.end(), c_InvalidID);
+	}
+
+	SymbolID SymbolTable::Intern(std::string_view name)
+	{
+		std::uint64_t hash = Utils::HashString(name);
+		std::size_t   mask = m_SymbolSlots.size() - 1;
+		for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask)
+		{
+			SymbolID symbol = m_SymbolSlots[slot];
+			if (symbol == c_InvalidID)
+				break;
+			if (m_Symbols[symbol].Hash == hash && NameOf(symbol) == name)
+				return symbol;
+		}
+
+		SymbolID symbol = static_cast<SymbolID>(m_Symbols.size());
+		m_Symbols.push_back({ .Offset = static_cast<std::uint32_t>(m_Characters.size()), .Length = static_cast<std::uint32_t>(name.size()), .Hash = hash });
+		m_Characters.insert(m_Characters.end(), name.begin(), name.end());
+		if (m_Symbols.size() * 2 > m_SymbolSlots.size())
+		{
+			GrowSymbolSlots();
+		}
+		else
+		{
+			std::size_t slot = hash & mask;
+			while (m_SymbolSlots[slot] != c_InvalidID)
+				slot = (slot + 1) & mask;
+			m_SymbolSlots[slot] = symbol;
+		}
+		return symbol;
+	}
+
+	SymbolID SymbolTable::Find(std::string_view name) const
+	{
+		std::uint64_t hash = Utils::HashString(name);
+		std::size_t   mask = m_SymbolSlots.size() - 1;
+		for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask)
+		{
+			SymbolID symbol = m_SymbolSlots[slot];
+			if (symbol == c_InvalidID || (m_Symbols[symbol].Hash == hash && NameOf(symbol) == name))
+				return symbol;
+		}
+	}
+
+	std::string_view SymbolTable::NameOf(SymbolID symbol) const
+	{
+		if (symbol >= m_Symbols.size())
+			return {};
+		const Symbol& value = m_Symbols[symbol];
+		return { m_Characters.data() + value.Offset, value.Length };
+	}
+
+	ScopeID SymbolTable::Scope(ScopeID parent, SymbolID name)
+	{
+		std::uint64_t hash = ScopeHash(parent, name);
+		std::size_t   mask = m_ScopeSlots.size() - 1;
+		for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask)
+		{
+			ScopeID scope = m_ScopeSlots[slot];
+			if (scope == c_InvalidID)
+				break;
+			if (m_Scopes[scope].Parent == parent && m_Scopes[scope].Name == name)
+				return scope;
+		}
+
+		ScopeID scope = static_cast<ScopeID>(m_Scopes.size());
+		m_Scopes.push_back({ .Parent = parent, .Name = name });
+		if (m_Scopes.size() * 2 > m_ScopeSlots.size())
+		{
+			GrowScopeSlots();
+		}
+		else
+		{
+			std::size_t slot = hash & mask;
+			while (m_ScopeSlots[slot] != c_InvalidID)
+				slot = (slot + 1) & mask;
+			m_ScopeSlots[slot] = scope;
+		}
+		return scope;
+	}
+
+	ScopeID SymbolTable::FindScope(ScopeID parent, SymbolID name) const
+	{
+		std::uint64_t hash = ScopeHash(parent, name);
+		std::size_t   mask = m_ScopeSlots.size() - 1;
+		for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask)
+		{
+			ScopeID scope = m_ScopeSlots[slot];
+			if (scope == c_InvalidID || (m_Scopes[scope].Parent == parent && m_Scopes[scope].Name == name))
+				return scope;
+		}
+	}
+
+	void SymbolTable::AppendQualifiedName(ScopeID scope, SymbolID name, std::string& out) const
+	{
+		if (scope != c_GlobalScope && scope < m_Scopes.size())
+		{
+			AppendQualifiedName(m_Scopes[scope].Parent, m_Scopes[scope].Name, out);
+			out.append("::");
+		}
+		out.append(NameOf(name));
+	}
+
+	std::uint64_t SymbolTable::ScopeHash(ScopeID parent, SymbolID name)
+	{
+		return Utils::HashMix((static_cast<std::uint64_t>(parent) << 32) | name);
+	}
+
+	void SymbolTable::GrowSymbolSlots()
+	{
+		m_SymbolSlots.assign(m_SymbolSlots.size() * 2, c_InvalidID);
+		std::size_t mask = m_SymbolSlots.size() - 1;
+		for (SymbolID symbol = 0; symbol < m_Symbols.size(); ++symbol)
+		{
+			std::size_t slot = m_Symbols[symbol].Hash & mask;
+			while (m_SymbolSlots[slot] != c_InvalidID)
+				slot = (slot + 1) & mask;
+			m_SymbolSlots[slot] = symbol;
+		}
+	}
+
+	void SymbolTable::GrowScopeSlots()
+	{
+		m_ScopeSlots.assign(m_ScopeSlots.size() * 2, c_InvalidID);
+		std::size_t mask = m_ScopeSlots.size() - 1;
+		// The global scope is never looked up, so it has no slot
+		for (ScopeID scope = 1; scope < m_Scopes.size(); ++scope)
+		{
+			std::size_t slot = ScopeHash(m_Scopes[scope].Parent, m_Scopes[scope].Name) & mask;
+			while (m_ScopeSlots[slot] != c_InvalidID)
+				slot = (slot + 1) & mask;
+			m_ScopeSlots[slot] = scope;
+		}
+	}
+} // namespace Frertex::Compiler
@@ -0,0 +1,146 @@
+#include "Frertex/Compiler/TypeTable.h"
+#include "Frertex/Utils/Hash.h"
+
+#include <algorithm>
+
+namespace Frertex::Compiler
+{
+	static constexpr std::size_t c_InitialTypeSlots = 64;
+
+	struct BuiltinScalar
+	{
+	public:
+		std::string_view Name;
+		FIL::ETypeClass  Class;
+	};
+
+	static constexpr BuiltinScalar c_BuiltinScalars[] = {
+		{ "void",   FIL::ETypeClass::Void   },
+		{ "bool",   FIL::ETypeClass::Bool   },
+		{ "int",    FIL::ETypeClass::Int    },
+		{ "uint",   FIL::ETypeClass::UInt   },
+		{ "half",   FIL::ETypeClass::Half   },
+		{ "float",  FIL::ETypeClass::Float  },
+		{ "double", FIL::ETypeClass::Double }
+	};
+
+	TypeTable::TypeTable()
+	{
+		Clear();
+	}
+
+	void TypeTable::Clear()
+	{
+		m_Types.clear();
+		if (m_Slots.empty())
+			m_Slots.resize(c_InitialTypeSlots);
+		std::fill(m_Slots.begin(), m_Slots.end(), c_InvalidID);
+		std::fill(m_GlobalNameTypes.begin(), m_GlobalNameTypes.end(), c_InvalidID);
+		Intern({ .Class = FIL::ETypeClass::Void, .Rows = 1, .Columns = 1, .Scope = c_InvalidID, .Name = c_InvalidID });
+	}
+
+	TypeID TypeTable::Intern(const Type& type)
+	{
+		std::uint64_t hash = Hash(type);
+		std::size_t   mask = m_Slots.size() - 1;
+		std::size_t   slot = hash & mask;
+		for (; m_Slots[slot] != c_InvalidID; slot = (slot + 1) & mask)
+			if (m_Types[m_Slots[slot]] == type)
+				return m_Slots[slot];
+
+		TypeID id = static_cast<TypeID>(m_Types.size());
+		m_Types.push_back(type);
+		m_Slots[slot] = id;
+		if (m_Types.size() * 2 > m_Slots.size())
+			GrowSlots();
+		return id;
+	}
+
+	TypeID TypeTable::FromName(const SymbolTable& symbols, ScopeID scope, SymbolID name)
+	{
+		bool global = scope == SymbolTable::c_GlobalScope;
+		if (global)
+		{
+			if (name >= m_GlobalNameTypes.size())
+				m_GlobalNameTypes.resize(std::max<std::size_t>(name + 1, m_GlobalNameTypes.size() * 2), c_InvalidID);
+			if (m_GlobalNameTypes[name] != c_InvalidID)
+				return m_GlobalNameTypes[name];
+		}
+
+		Type type;
+		if (!global || !ParseBuiltin(symbols.NameOf(name), type))
+			type = { .Class = FIL::ETypeClass::Named, .Rows = 1, .Columns = 1, .Scope = scope, .Name = name };
+
+		TypeID id = Intern(type);
+		if (global)
+			m_GlobalNameTypes[name] = id;
+		return id;
+	}
+
+	void TypeTable::Emit(const SymbolTable& symbols, std::vector<FIL::Type>& types, std::vector<std::uint8_t>& names)
+	{
+		types.reserve(types.size() + m_Types.size());
+		for (auto& type : m_Types)
+		{
+			FIL::Type& out = types.emplace_back();
+			out.Class      = type.Class;
+			out.Rows       = type.Rows;
+			out.Columns    = type.Columns;
+			out.NameOffset = 0;
+			out.NameLength = 0;
+			if (type.Class != FIL::ETypeClass::Named)
+				continue;
+
+			m_Name.clear();
+			symbols.AppendQualifiedName(type.Scope, type.Name, m_Name);
+			out.NameOffset = names.size();
+			out.NameLength = m_Name.size();
+			names.insert(names.end(), m_Name.begin(), m_Name.end());
+		}
+	}
+
+	std::uint64_t TypeTable::Hash(const Type& type)
+	{
+		std::uint64_t hash = Utils::HashMix(static_cast<std::uint64_t>(type.Class) | static_cast<std::uint64_t>(type.Rows) << 8 | static_cast<std::uint64_t>(type.Columns) << 16);
+		return Utils::HashCombine(hash, static_cast<std::uint64_t>(type.Scope) << 32 | type.Name);
+	}
+
+	bool TypeTable::ParseBuiltin(std::string_view name, Type& type)
+	{
+		for (auto& scalar : c_BuiltinScalars)
+		{
+			if (!name.starts_with(scalar.Name))
+				continue;
+
+			std::string_view dimensions = name.substr(scalar.Name.size());
+			type                        = { .Class = scalar.Class, .Rows = 1, .Columns = 1, .Scope = c_InvalidID, .Name = c_InvalidID };
+			if (dimensions.empty())
+				return true;
+			if (scalar.Class == FIL::ETypeClass::Void || dimensions[0] < '1' || dimensions[0] > '4')
+				return false;
+
+			// 'float4' is a vector of four rows, 'float4x3' a matrix of four rows and three columns
+			type.Rows = static_cast<std::uint8_t>(dimensions[0] - '0');
+			if (dimensions.size() == 1)
+				return true;
+			if (dimensions.size() != 3 || dimensions[1] != 'x' || dimensions[2] < '1' || dimensions[2] > '4')
+				return false;
+			type.Columns = static_cast<std::uint8_t>(dimensions[2] - '0');
+			return true;
+		}
+		return false;
+	}
+
+	void TypeTable::GrowSlots()
+	{
+		m_Slots.assign(m_Slots.size() * 2, c_InvalidID);
+		std::size_t mask = m_Slots.size() - 1;
+		for (TypeID id = 0; id < m_Types.size(); ++id)
+		{
+			std::size_t slot = Hash(m_Types[id]) & mask;
+			while (m_Slots[slot] != c_InvalidID)
+				slot = (slot + 1) & mask;
+			m_Slots[slot] = id;
+		}
+	}
+} // namespace Frertex::Compiler
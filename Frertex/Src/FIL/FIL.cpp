@@ -1,36 +1,51 @@
 #include "Frertex/FIL/FIL.h"
 #include "Frertex/Utils/Buffer.h"
+#include "Frertex/Utils/Lookups.h"
+
+#include <iterator>
 
 namespace Frertex::FIL
 {
+	// In the order of Lookups::c_EntrypointTypeNames
+	static constexpr EEntrypointType c_EntrypointTypes[] {
+		EEntrypointType::VertexShader,
+		EEntrypointType::TessellationControlShader,
+		EEntrypointType::TessellationEvaluationShader,
+		EEntrypointType::GeometryShader,
+		EEntrypointType::FragmentShader,
+		EEntrypointType::ComputeShader,
+		EEntrypointType::RayGenShader,
+		EEntrypointType::AnyHitShader,
+		EEntrypointType::ClosestHitShader,
+		EEntrypointType::MissShader,
+		EEntrypointType::IntersectionShader,
+		EEntrypointType::CallableShader,
+		EEntrypointType::TaskShader,
+		EEntrypointType::MeshShader
+	};
+	static_assert(std::size(c_EntrypointTypes) == std::size(Utils::Lookups::c_EntrypointTypeNames));
+
+	// In the order of Lookups::c_TypeQualifierNames
+	static constexpr ETypeQualifier c_TypeQualifiers[] {
+		ETypeQualifier::In,
+		ETypeQualifier::Out,
+		ETypeQualifier::InOut
+	};
+	static_assert(std::size(c_TypeQualifiers) == std::size(Utils::Lookups::c_TypeQualifierNames));
+
 	EEntrypointType EntrypointTypeFromString(std::string_view str)
 	{
-		if (str == "VertexShader") return EEntrypointType::VertexShader;
-		if (str == "TessellationControlShader") return EEntrypointType::TessellationControlShader;
-		if (str == "TessellationEvaluationShader") return EEntrypointType::TessellationEvaluationShader;
-		if (str == "GeometryShader") return EEntrypointType::GeometryShader;
-		if (str == "FragmentShader") return EEntrypointType::FragmentShader;
-		if (str == "ComputeShader") return EEntrypointType::ComputeShader;
-		if (str == "RayGenShader") return EEntrypointType::RayGenShader;
-		if (str == "AnyHitShader") return EEntrypointType::AnyHitShader;
-		if (str == "ClosestHitShader") return EEntrypointType::ClosestHitShader;
-		if (str == "MissShader") return EEntrypointType::MissShader;
-		if (str == "IntersectionShader") return EEntrypointType::IntersectionShader;
-		if (str == "CallableShader") return EEntrypointType::CallableShader;
-		if (str == "TaskShader") return EEntrypointType::TaskShader;
-		if (str == "MeshShader") return EEntrypointType::MeshShader;
-		return EEntrypointType::None;
+		std::uint32_t index = Utils::Lookups::FindEntrypointType(str);
+		return index != Utils::Lookups::c_NotFound ? c_EntrypointTypes[index] : EEntrypointType::None;
 	}
 
 	ETypeQualifier TypeQualifierFromString(std::string_view str)
 	{
-		if (str == "in") return ETypeQualifier::In;
-		if (str == "out") return ETypeQualifier::Out;
-		if (str == "inout") return ETypeQualifier::InOut;
-		return ETypeQualifier::None;
+		std::uint32_t index = Utils::Lookups::FindTypeQualifier(str);
+		return index != Utils::Lookups::c_NotFound ? c_TypeQualifiers[index] : ETypeQualifier::None;
 	}
 
-	static Binary ParseBinary1(Utils::View<std::uint8_t> data, [[maybe_unused]] std::uint16_t minor, [[maybe_unused]] std::uint8_t patch)
+	static Binary ParseBinary1(Utils::View<std::uint8_t> data, std::uint16_t minor, [[maybe_unused]] std::uint8_t patch)
 	{
 		Binary binary {};
 
@@ -40,6 +55,10 @@ namespace Frertex::FIL
 		binary.Functions.resize(buffer.PopU64());
 		binary.Strings.resize(buffer.PopU64());
 		binary.Code.resize(buffer.PopU64());
+		if (minor >= 1) // 1.1 added the type section
+			binary.Types.resize(buffer.PopU64());
+		if (minor >= 3) // 1.3 added the constant section
+			binary.Constants.resize(buffer.PopU64());
 
 		for (std::size_t i = 0; i < binary.Entrypoints.size(); ++i)
 		{
@@ -73,6 +92,8 @@ namespace Frertex::FIL
 			function.CodeLength = buffer.PopU64();
 			function.NameOffset = buffer.PopU64();
 			function.NameLength = buffer.PopU64();
+			if (minor >= 2) // 1.2 added return types
+				function.ReturnTypeID = buffer.PopU64();
 			function.Parameters.resize(buffer.PopU64());
 			for (std::size_t j = 0; j < function.Parameters.size(); ++j)
 			{
@@ -83,6 +104,24 @@ namespace Frertex::FIL
 			}
 		}
 
+		for (std::size_t i = 0; i < binary.Types.size(); ++i)
+		{
+			auto& type   = binary.Types[i];
+			type.Class   = static_cast<ETypeClass>(buffer.PopU8());
+			type.Rows    = buffer.PopU8();
+			type.Columns = buffer.PopU8();
+			buffer.AlignU64();
+			type.NameOffset = buffer.PopU64();
+			type.NameLength = buffer.PopU64();
+		}
+
+		for (std::size_t i = 0; i < binary.Constants.size(); ++i)
+		{
+			auto& constant  = binary.Constants[i];
+			constant.TypeID = buffer.PopU64();
+			constant.Value  = buffer.PopU64();
+		}
+
 		buffer.PopU8s(binary.Strings);
 		buffer.PopU32s(binary.Code);
 
@@ -109,12 +148,14 @@ namespace Frertex::FIL
 		Utils::WriteBuffer buffer { data };
 		// Header
 		buffer.PushU32(0x0046'494C); // Magic "\0FIL"
-		buffer.PushU32(0x0100'0000); // Version 1.0.0
+		buffer.PushU32(c_Version);
 
 		buffer.PushU64(binary.Entrypoints.size());
 		buffer.PushU64(binary.Functions.size());
 		buffer.PushU64(binary.Strings.size());
 		buffer.PushU64(binary.Code.size());
+		buffer.PushU64(binary.Types.size());
+		buffer.PushU64(binary.Constants.size());
 
 		// Data
 		for (auto& entrypoint : binary.Entrypoints)
@@ -145,6 +186,7 @@ namespace Frertex::FIL
 			buffer.PushU64(function.CodeLength);
 			buffer.PushU64(function.NameOffset);
 			buffer.PushU64(function.NameLength);
+			buffer.PushU64(function.ReturnTypeID);
 			buffer.PushU64(function.Parameters.size());
 			for (auto& parameter : function.Parameters)
 			{
@@ -154,6 +196,22 @@ namespace Frertex::FIL
 			}
 		}
 
+		for (auto& type : binary.Types)
+		{
+			buffer.PushU8(static_cast<std::uint8_t>(type.Class));
+			buffer.PushU8(type.Rows);
+			buffer.PushU8(type.Columns);
+			buffer.AlignU64();
+			buffer.PushU64(type.NameOffset);
+			buffer.PushU64(type.NameLength);
+		}
+
+		for (auto& constant : binary.Constants)
+		{
+			buffer.PushU64(constant.TypeID);
+			buffer.PushU64(constant.Value);
+		}
+
 		buffer.PushU8s(binary.Strings);
 		buffer.PushU32s(binary.Code);
 
@@ -0,0 +1,239 @@
+#include "Frertex/IR/IR.h"
+
+namespace Frertex::IR
+{
+	void Module::Clear()
+	{
+		m_Instructions.clear();
+		m_Operands.clear();
+		m_Uses.clear();
+		m_Blocks.clear();
+		m_Functions.clear();
+		m_FreeUses = c_NoRef;
+	}
+
+	std::uint32_t Module::BeginFunction(std::uint32_t declaration)
+	{
+		m_Functions.push_back({ .FirstBlock       = static_cast<Ref>(m_Blocks.size()),
+								.BlockCount       = 0,
+								.FirstInstruction = static_cast<Ref>(m_Instructions.size()),
+								.InstructionCount = 0,
+								.Declaration      = declaration });
+		return static_cast<std::uint32_t>(m_Functions.size() - 1);
+	}
+
+	Ref Module::BeginBlock()
+	{
+		m_Blocks.push_back({ .FirstInstruction = static_cast<Ref>(m_Instructions.size()), .InstructionCount = 0 });
+		++m_Functions.back().BlockCount;
+		return static_cast<Ref>(m_Blocks.size() - 1);
+	}
+
+	Ref Module::Add(FIL::EOpcode opcode, std::uint32_t type, Utils::View<std::uint32_t> operands, std::uint64_t node)
+	{
+		Ref instruction = static_cast<Ref>(m_Instructions.size());
+		m_Instructions.push_back({ .Opcode       = opcode,
+								   .OperandCount = static_cast<std::uint16_t>(operands.size()),
+								   .Type         = HasResult(opcode) ? type : c_NoRef,
+								   .FirstOperand = static_cast<std::uint32_t>(m_Operands.size()),
+								   .Block        = CurrentBlock(),
+								   .FirstUse     = c_NoRef,
+								   .Node         = node });
+		m_Operands.insert(m_Operands.end(), operands.begin(), operands.end());
+		for (std::uint32_t i = 0; i < operands.size(); ++i)
+			if (IsValueOperand(opcode, i) && operands[i] != c_NoRef)
+				AddUse(instruction, i);
+		++m_Blocks.back().InstructionCount;
+		++m_Functions.back().InstructionCount;
+		return instruction;
+	}
+
+	void Module::SetOperand(Ref instruction, std::uint32_t operand, std::uint32_t value)
+	{
+		bool           isValue = IsValueOperand(m_Instructions[instruction].Opcode, operand);
+		std::uint32_t& slot    = m_Operands[m_Instructions[instruction].FirstOperand + operand];
+		if (isValue && slot != c_NoRef)
+			RemoveUse(instruction, operand);
+		slot = value;
+		if (isValue && value != c_NoRef)
+			AddUse(instruction, operand);
+	}
+
+	void Module::ReplaceAllUses(Ref from, Ref to)
+	{
+		if (from == to)
+			return;
+
+		Ref use = m_Instructions[from].FirstUse;
+		if (use == c_NoRef)
+			return;
+
+		Ref last = use;
+		for (; use != c_NoRef; use = m_Uses[use].Next)
+		{
+			const Use& value = m_Uses[use];
+			m_Operands[m_Instructions[value.User].FirstOperand + value.Operand] = to;
+			last = use;
+		}
+		// The whole list moves over to 'to'
+		m_Uses[last].Next             = m_Instructions[to].FirstUse;
+		m_Instructions[to].FirstUse   = m_Instructions[from].FirstUse;
+		m_Instructions[from].FirstUse = c_NoRef;
+	}
+
+	void Module::SetConstant(Ref instruction, std::uint32_t constant)
+	{
+		Instruction& value = m_Instructions[instruction];
+		for (std::uint32_t i = 0; i < value.OperandCount; ++i)
+			if (IsValueOperand(value.Opcode, i) && m_Operands[value.FirstOperand + i] != c_NoRef)
+				RemoveUse(instruction, i);
+		value.Opcode                   = FIL::EOpcode::Constant;
+		value.OperandCount             = 1;
+		m_Operands[value.FirstOperand] = constant;
+	}
+
+	void Module::Remove(Ref instruction)
+	{
+		Instruction& value = m_Instructions[instruction];
+		for (std::uint32_t i = 0; i < value.OperandCount; ++i)
+			if (IsValueOperand(value.Opcode, i) && m_Operands[value.FirstOperand + i] != c_NoRef)
+				RemoveUse(instruction, i);
+		value.Opcode       = FIL::EOpcode::Nop;
+		value.OperandCount = 0;
+		value.Type         = c_NoRef;
+	}
+
+	void Module::Emit(std::uint32_t function, std::vector<std::uint32_t>& code, Utils::View<std::uint32_t> constants)
+	{
+		// Phis may use values defined further down, so results are numbered before any code is written
+		const Function& value = m_Functions[function];
+		m_Results.resize(value.InstructionCount);
+		std::uint32_t resultCount = 0;
+		for (std::uint32_t i = 0; i < value.InstructionCount; ++i)
+		{
+			FIL::EOpcode opcode = m_Instructions[value.FirstInstruction + i].Opcode;
+			m_Results[i]        = HasResult(opcode) ? resultCount++ : c_NoRef;
+		}
+
+		for (Ref block = value.FirstBlock; block < value.FirstBlock + value.BlockCount; ++block)
+		{
+			code.push_back(static_cast<std::uint32_t>(FIL::EOpcode::Label) | 2U << 16);
+			code.push_back(block - value.FirstBlock);
+
+			const Block& blockValue = m_Blocks[block];
+			for (Ref instruction = blockValue.FirstInstruction; instruction < blockValue.FirstInstruction + blockValue.InstructionCount; ++instruction)
+			{
+				const Instruction& inst = m_Instructions[instruction];
+				if (inst.Opcode == FIL::EOpcode::Nop)
+					continue;
+
+				bool          hasResult = HasResult(inst.Opcode);
+				std::uint32_t wordCount = 1 + (hasResult ? 2 : 0) + inst.OperandCount;
+				code.push_back(static_cast<std::uint32_t>(inst.Opcode) | wordCount << 16);
+				if (hasResult)
+				{
+					code.push_back(inst.Type);
+					code.push_back(m_Results[instruction - value.FirstInstruction]);
+				}
+				for (std::uint32_t i = 0; i < inst.OperandCount; ++i)
+				{
+					std::uint32_t operand = m_Operands[inst.FirstOperand + i];
+					if (inst.Opcode == FIL::EOpcode::Constant)
+						operand = constants[operand];
+					else if (IsValueOperand(inst.Opcode, i) && operand != c_NoRef)
+						operand = m_Results[operand - value.FirstInstruction];
+					else if (IsBlockOperand(inst.Opcode, i))
+						operand -= value.FirstBlock;
+					code.push_back(operand);
+				}
+			}
+		}
+	}
+
+	bool Module::HasResult(FIL::EOpcode opcode)
+	{
+		switch (opcode)
+		{
+		case FIL::EOpcode::Nop:
+		case FIL::EOpcode::Label:
+		case FIL::EOpcode::Store:
+		case FIL::EOpcode::Branch:
+		case FIL::EOpcode::BranchConditional:
+		case FIL::EOpcode::Return:
+			return false;
+		default:
+			return true;
+		}
+	}
+
+	bool Module::IsValueOperand(FIL::EOpcode opcode, std::uint32_t operand)
+	{
+		switch (opcode)
+		{
+		case FIL::EOpcode::Nop:
+		case FIL::EOpcode::Label:
+		case FIL::EOpcode::Parameter:
+		case FIL::EOpcode::Constant:
+		case FIL::EOpcode::Undefined:
+		case FIL::EOpcode::Branch:
+			return false;
+		case FIL::EOpcode::Call: return operand > 0;
+		case FIL::EOpcode::Phi: return (operand & 1) == 0;
+		case FIL::EOpcode::Store: return operand == 1;
+		case FIL::EOpcode::BranchConditional: return operand == 0;
+		default: return true;
+		}
+	}
+
+	bool Module::IsBlockOperand(FIL::EOpcode opcode, std::uint32_t operand)
+	{
+		switch (opcode)
+		{
+		case FIL::EOpcode::Label:
+		case FIL::EOpcode::Branch:
+			return true;
+		case FIL::EOpcode::Phi: return (operand & 1) == 1;
+		case FIL::EOpcode::BranchConditional: return operand > 0;
+		default: return false;
+		}
+	}
+
+	void Module::AddUse(Ref instruction, std::uint32_t operand)
+	{
+		Ref          value = m_Operands[m_Instructions[instruction].FirstOperand + operand];
+		Instruction& used  = m_Instructions[value];
+
+		Ref use;
+		if (m_FreeUses != c_NoRef)
+		{
+			use        = m_FreeUses;
+			m_FreeUses = m_Uses[use].Next;
+		}
+		else
+		{
+			use = static_cast<Ref>(m_Uses.size());
+			m_Uses.emplace_back();
+		}
+		m_Uses[use]   = { .User = instruction, .Operand = operand, .Next = used.FirstUse };
+		used.FirstUse = use;
+	}
+
+	void Module::RemoveUse(Ref instruction, std::uint32_t operand)
+	{
+		Ref  value = m_Operands[m_Instructions[instruction].FirstOperand + operand];
+		Ref* link  = &m_Instructions[value].FirstUse;
+		while (*link != c_NoRef)
+		{
+			Use& use = m_Uses[*link];
+			if (use.User == instruction && use.Operand == operand)
+			{
+				Ref removed = *link;
+				*link       = use.Next;
+				use.Next    = m_FreeUses;
+				m_FreeUses  = removed;
+				return;
+			}
+			link = &use.Next;
+		}
+	}
+} // namespace Frertex::IR
@@ -0,0 +1,152 @@
+#include "Frertex/Parser/Literals.h"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+namespace Frertex::Parser
+{
+	static constexpr std::uint64_t c_Pow10[9] = { 1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000 };
+
+	static bool IsDecimalDigits(const char* chars, std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+			if (chars[i] < '0' || chars[i] > '9')
+				return false;
+		return true;
+	}
+
+	static std::uint64_t ParseEightDigits(const char* chars)
+	{
+		if constexpr (std::endian::native == std::endian::little)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, chars, 8);
+			word -= 0x3030'3030'3030'3030ULL;
+			word = (word * 10) + (word >> 8);
+			return (((word & 0x0000'00FF'0000'00FFULL) * (100 + (1'000'000ULL << 32))) +
+					(((word >> 16) & 0x0000'00FF'0000'00FFULL) * (1 + (10'000ULL << 32)))) >>
+				   32;
+		}
+		else
+		{
+			std::uint64_t value = 0;
+			for (std::size_t i = 0; i < 8; ++i)
+				value = value * 10 + static_cast<std::uint64_t>(chars[i] - '0');
+			return value;
+		}
+	}
+
+	static bool DecodeDecimal(std::string_view digits, std::uint64_t& value)
+	{
+		// Runs of eight digits without separators take the SWAR path, everything else goes one character at a time
+		const char*   chars      = digits.data();
+		std::size_t   count      = digits.size();
+		std::uint64_t digitCount = 0;
+		value                    = 0;
+		while (count)
+		{
+			if (count >= 8 && IsDecimalDigits(chars, 8))
+			{
+				std::uint64_t chunk = ParseEightDigits(chars);
+				if (value > (~0ULL - chunk) / c_Pow10[8])
+					return false;
+				value       = value * c_Pow10[8] + chunk;
+				chars       += 8;
+				count       -= 8;
+				digitCount  += 8;
+				continue;
+			}
+
+			char c = *chars++;
+			--count;
+			if (c == '\'')
+				continue;
+			if (c < '0' || c > '9')
+				return false;
+			std::uint64_t digit = static_cast<std::uint64_t>(c - '0');
+			if (value > (~0ULL - digit) / 10)
+				return false;
+			value = value * 10 + digit;
+			++digitCount;
+		}
+		return digitCount != 0;
+	}
+
+	static bool DecodePowerOfTwo(std::string_view digits, std::uint32_t bitsPerDigit, std::uint64_t& value)
+	{
+		std::uint32_t base       = 1U << bitsPerDigit;
+		std::uint32_t bits       = 0;
+		std::uint64_t digitCount = 0;
+		value                    = 0;
+		for (char c : digits)
+		{
+			if (c == '\'')
+				continue;
+
+			std::uint32_t digit;
+			if (c >= '0' && c <= '9')
+				digit = static_cast<std::uint32_t>(c - '0');
+			else if (c >= 'a' && c <= 'f')
+				digit = static_cast<std::uint32_t>(c - 'a' + 10);
+			else if (c >= 'A' && c <= 'F')
+				digit = static_cast<std::uint32_t>(c - 'A' + 10);
+			else
+				return false;
+			if (digit >= base)
+				return false;
+
+			if (bits)
+				bits += bitsPerDigit;
+			else
+				bits = static_cast<std::uint32_t>(std::bit_width(digit));
+			if (bits > 64)
+				return false;
+			value = (value << bitsPerDigit) | digit;
+			++digitCount;
+		}
+		return digitCount != 0;
+	}
+
+	bool DecodeIntegerLiteral(Tokenizer::ETokenClass clazz, std::string_view literal, std::uint64_t& value)
+	{
+		switch (clazz)
+		{
+		case Tokenizer::ETokenClass::DecimalInteger: return DecodeDecimal(literal, value);
+		case Tokenizer::ETokenClass::BinaryInteger: return literal.size() > 2 && DecodePowerOfTwo(literal.substr(2), 1, value);
+		case Tokenizer::ETokenClass::OctalInteger: return literal.size() > 2 && DecodePowerOfTwo(literal.substr(2), 3, value);
+		case Tokenizer::ETokenClass::HexInteger: return literal.size() > 2 && DecodePowerOfTwo(literal.substr(2), 4, value);
+		default: return false;
+		}
+	}
+
+	bool DecodeFloatLiteral(Tokenizer::ETokenClass clazz, std::string_view literal, double& value, std::string& scratch)
+	{
+		std::chars_format format = std::chars_format::general;
+		switch (clazz)
+		{
+		case Tokenizer::ETokenClass::Float: break;
+		case Tokenizer::ETokenClass::HexFloat:
+			if (literal.size() <= 2)
+				return false;
+			literal = literal.substr(2);
+			format  = std::chars_format::hex;
+			break;
+		default: return false;
+		}
+
+		// from_chars wants the digits contiguous, only literals with separators are copied
+		if (literal.find('\'') != std::string_view::npos)
+		{
+			scratch.clear();
+			for (char c : literal)
+				if (c != '\'')
+					scratch.push_back(c);
+			literal = scratch;
+		}
+
+		const char* end    = literal.data() + literal.size();
+		auto        result = std::from_chars(literal.data(), end, value, format);
+		return result.ec == std::errc {} && result.ptr == end;
+	}
+} // namespace Frertex::Parser
@@ -1,14 +1,190 @@
 #include "Frertex/Parser/Parser.h"
+#include "Frertex/Parser/Literals.h"
+
+#include <chrono>
+#include <thread>
 
 namespace Frertex::Parser
 {
-	AST::AST State::Parse(std::string_view source, Utils::View<Tokenizer::Token> tokens)
+	std::string_view RuleToString(ERule rule)
+	{
+		switch (rule)
+		{
+		case ERule::Declarations: return "Declarations";
+		case ERule::Declaration: return "Declaration";
+		case ERule::FunctionDeclaration: return "FunctionDeclaration";
+		case ERule::Statements: return "Statements";
+		case ERule::Statement: return "Statement";
+		case ERule::EmptyStatement: return "EmptyStatement";
+		case ERule::CompoundStatement: return "CompoundStatement";
+		case ERule::LazyCompoundStatement: return "LazyCompoundStatement";
+		case ERule::ExpressionStatement: return "ExpressionStatement";
+		case ERule::Expression: return "Expression";
+		case ERule::Parameters: return "Parameters";
+		case ERule::Parameter: return "Parameter";
+		case ERule::Arguments: return "Arguments";
+		case ERule::Argument: return "Argument";
+		case ERule::Attributes: return "Attributes";
+		case ERule::Attribute: return "Attribute";
+		case ERule::Typename: return "Typename";
+		case ERule::TypeQualifier: return "TypeQualifier";
+		case ERule::Literal: return "Literal";
+		case ERule::IntegerLiteral: return "IntegerLiteral";
+		case ERule::FloatLiteral: return "FloatLiteral";
+		case ERule::BoolLiteral: return "BoolLiteral";
+		case ERule::BinaryIntegerLiteral: return "BinaryIntegerLiteral";
+		case ERule::OctalIntegerLiteral: return "OctalIntegerLiteral";
+		case ERule::DecimalIntegerLiteral: return "DecimalIntegerLiteral";
+		case ERule::HexIntegerLiteral: return "HexIntegerLiteral";
+		case ERule::DecimalFloatLiteral: return "DecimalFloatLiteral";
+		case ERule::HexFloatLiteral: return "HexFloatLiteral";
+		case ERule::Identifier: return "Identifier";
+		case ERule::COUNT: break;
+		}
+		return "Unknown";
+	}
+
+	struct OperatorInfo
+	{
+	public:
+		std::string_view Symbol;
+		AST::EOperator   Operator;
+		std::uint8_t     Precedence;
+		bool             RightAssociative = false;
+	};
+
+	// Higher precedence binds tighter, 0 is reserved for open parentheses
+	static constexpr OperatorInfo c_BinaryOperators[] = {
+		{ "=", AST::EOperator::Assign, 1, true },
+		{ "||", AST::EOperator::LogicalOr, 2 },
+		{ "&&", AST::EOperator::LogicalAnd, 3 },
+		{ "|", AST::EOperator::BitOr, 4 },
+		{ "^", AST::EOperator::BitXor, 5 },
+		{ "&", AST::EOperator::BitAnd, 6 },
+		{ "==", AST::EOperator::Equal, 7 },
+		{ "!=", AST::EOperator::NotEqual, 7 },
+		{ "<", AST::EOperator::Less, 8 },
+		{ "<=", AST::EOperator::LessEqual, 8 },
+		{ ">", AST::EOperator::Greater, 8 },
+		{ ">=", AST::EOperator::GreaterEqual, 8 },
+		{ "<<", AST::EOperator::ShiftLeft, 9 },
+		{ ">>", AST::EOperator::ShiftRight, 9 },
+		{ "+", AST::EOperator::Add, 10 },
+		{ "-", AST::EOperator::Subtract, 10 },
+		{ "*", AST::EOperator::Multiply, 11 },
+		{ "/", AST::EOperator::Divide, 11 },
+		{ "%", AST::EOperator::Remainder, 11 }
+	};
+
+	// Prefix operators bind tighter than any binary operator, calls bind tighter still
+	static constexpr OperatorInfo c_UnaryOperators[] = {
+		{ "-", AST::EOperator::Negate, 12, true },
+		{ "+", AST::EOperator::Plus, 12, true },
+		{ "!", AST::EOperator::LogicalNot, 12, true },
+		{ "~", AST::EOperator::BitNot, 12, true }
+	};
+
+	template <std::size_t N>
+	static const OperatorInfo* FindOperator(const OperatorInfo (&table)[N], std::string_view symbol)
+	{
+		for (auto& info : table)
+			if (info.Symbol == symbol)
+				return &info;
+		return nullptr;
+	}
+
+	static bool IsUnaryOperator(AST::EOperator op)
+	{
+		return op >= AST::EOperator::Negate;
+	}
+
+#if FRERTEX_PARSER_PROFILING
+	// Lives for the duration of one Parse* call, successful results are passed through Exit
+	struct RuleProfiler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+	public:
+		RuleProfiler(State& state, ERule rule)
+			: m_State(state),
+			  m_Stats(state.m_Profile[rule]),
+			  m_Nodes(state.m_AST.Size()),
+			  m_BacktrackedNodes(state.m_BacktrackedNodes),
+			  m_Start(Clock::now())
+		{
+			++m_Stats.Attempts;
+		}
+
+		~RuleProfiler()
+		{
+			std::uint64_t backtracked = m_State.m_BacktrackedNodes - m_BacktrackedNodes;
+			m_Stats.NodesAllocated    += m_State.m_AST.Size() - m_Nodes + backtracked;
+			m_Stats.NodesFreed        += backtracked;
+			m_Stats.Nanoseconds       += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_Start).count();
+		}
+
+		ParseResult Exit(ParseResult result)
+		{
+			if (result)
+			{
+				++m_Stats.Successes;
+				m_Stats.TokensConsumed += result.UsedTokens;
+			}
+			return result;
+		}
+
+	private:
+		State&            m_State;
+		RuleStats&        m_Stats;
+		std::uint64_t     m_Nodes;
+		std::uint64_t     m_BacktrackedNodes;
+		Clock::time_point m_Start;
+	};
+#else
+	struct RuleProfiler
+	{
+	public:
+		RuleProfiler([[maybe_unused]] State& state, [[maybe_unused]] ERule rule) {}
+
+		ParseResult Exit(ParseResult result) { return result; }
+	};
+#endif
+
+	AST::AST State::Parse(std::string_view source, Utils::View<Tokenizer::Token> tokens, ParseOptions options)
+	{
+		AST::AST ast;
+		Parse(ast, source, tokens, options);
+		return ast;
+	}
+
+	void State::Parse(AST::AST& ast, std::string_view source, Utils::View<Tokenizer::Token> tokens, ParseOptions options)
 	{
+		ast.Clear();
 		if (tokens.empty())
-			return {};
+			return;
+
+		m_Source  = source;
+		m_Tokens  = tokens;
+		m_Options = options;
+		m_AST     = std::move(ast);
+
+		auto result = ParseDeclarations(tokens);
+		m_AST.SetRootNode(result.Node);
 
-		m_Source = source;
-		m_AST    = AST::AST {};
+		ast = std::move(m_AST);
+	}
+
+	AST::AST State::Parse(std::string_view source, TokenSource& tokens)
+	{
+		// Streamed tokens are dropped once consumed, so there is nothing a lazy body could refer back to
+		m_Source  = source;
+		m_Tokens  = {};
+		m_Options = {};
+		m_AST     = AST::AST {};
+
+		if (!tokens.Request(1))
+			return {};
 
 		auto result = ParseDeclarations(tokens);
 		m_AST.SetRootNode(result.Node);
@@ -16,7 +192,155 @@ namespace Frertex::Parser
 		return std::move(m_AST);
 	}
 
-	void State::ReportError(Utils::View<Tokenizer::Token> tokens, std::size_t point, std::string message)
+	ReparseResult State::Reparse(AST::AST& ast, std::string_view source, Utils::View<Tokenizer::Token> tokens, const Tokenizer::Edit& edit, const Tokenizer::RetokenizeResult& retokenized, ParseOptions options)
+	{
+		ReparseResult result {};
+		if (ast.RootNode() == ~0ULL || tokens.empty())
+		{
+			Parse(ast, source, tokens, options);
+			return result;
+		}
+
+		m_Source  = source;
+		m_Tokens  = tokens;
+		m_Options = options;
+		m_AST     = std::move(ast);
+
+		std::uint64_t changedBegin = retokenized.FirstToken;
+		std::uint64_t changedEnd   = retokenized.FirstToken + retokenized.RemovedTokens;
+		std::uint64_t tokenDelta   = retokenized.InsertedTokens - retokenized.RemovedTokens;
+		std::uint64_t byteDelta    = edit.InsertedLength - edit.RemovedLength;
+
+		// Declarations are in token order, the ones in front of the change and behind it are kept
+		std::uint64_t root   = m_AST.RootNode();
+		std::uint64_t before = ~0ULL;
+		std::uint64_t after  = ~0ULL;
+		std::uint64_t decl   = m_AST[root].Child;
+		while (decl != ~0ULL)
+		{
+			std::uint64_t   next  = m_AST[decl].NextSibling;
+			AST::TokenRange range = m_AST.TokenRangeOf(decl);
+			if (range.Count != 0 && range.First + range.Count <= changedBegin)
+			{
+				before = decl;
+				++result.ReusedDeclarations;
+			}
+			else if (range.Count != 0 && range.First >= changedEnd)
+			{
+				if (after == ~0ULL)
+					after = decl;
+				ShiftDeclaration(decl, tokenDelta, byteDelta);
+				++result.ReusedDeclarations;
+			}
+			else
+			{
+				m_AST.FreeFull(decl);
+			}
+			decl = next;
+		}
+
+		AST::TokenRange beforeRange = m_AST.TokenRangeOf(before);
+		std::uint64_t   regionBegin = beforeRange.First + beforeRange.Count;
+		std::uint64_t   regionEnd   = 0;
+		std::uint64_t   stoppedAt   = 0;
+		std::uint64_t   failedAt    = ~0ULL;
+
+		ParseResult parsed;
+		while (true)
+		{
+			regionEnd = after != ~0ULL ? m_AST.TokenRangeOf(after).First : tokens.size();
+			parsed    = ParseDeclarations({ tokens.begin() + regionBegin, tokens.begin() + regionEnd });
+			stoppedAt = regionBegin + parsed.UsedTokens;
+			if (stoppedAt == regionEnd || after == ~0ULL || stoppedAt == failedAt)
+				break;
+
+			// Tokens in front of a kept declaration can belong to it, e.g. inserted attributes, so it is parsed again as part of the region
+			failedAt = stoppedAt;
+			m_AST.FreeFull(parsed.Node);
+			std::uint64_t next = m_AST[after].NextSibling;
+			m_AST.FreeFull(after);
+			--result.ReusedDeclarations;
+			after = next;
+		}
+
+		std::uint64_t firstNode = m_AST[parsed.Node].Child;
+		std::uint64_t lastNode  = before;
+		for (std::uint64_t node = firstNode; node != ~0ULL; node = m_AST[node].NextSibling)
+		{
+			lastNode = node;
+			++result.ReparsedDeclarations;
+		}
+		m_AST.Free(parsed.Node);
+
+		// A full parse stops at the first declaration it can't parse, so nothing behind an error is kept either
+		if (stoppedAt != regionEnd)
+		{
+			while (after != ~0ULL)
+			{
+				std::uint64_t next = m_AST[after].NextSibling;
+				m_AST.FreeFull(after);
+				--result.ReusedDeclarations;
+				after = next;
+			}
+		}
+
+		if (firstNode != ~0ULL)
+		{
+			m_AST.SetSiblings(before, firstNode);
+			m_AST.SetSiblings(lastNode, after);
+		}
+		else
+		{
+			m_AST.SetSiblings(before, after);
+		}
+		if (before == ~0ULL)
+			m_AST.SetParent(firstNode != ~0ULL ? firstNode : after, root);
+
+		ast = std::move(m_AST);
+		return result;
+	}
+
+	bool State::ExpandLazyBody(AST::AST& ast, std::uint64_t node, std::string_view source, Utils::View<Tokenizer::Token> tokens)
+	{
+		AST::TokenRange range = ast.TokenRangeOf(node);
+		if (range.Count == 0 || range.First + range.Count > tokens.size())
+			return false;
+
+		m_Source  = source;
+		m_Tokens  = tokens;
+		m_Options = {};
+		m_AST     = std::move(ast);
+
+		auto result = ParseCompoundStatement({ tokens.begin() + range.First, tokens.begin() + range.First + range.Count });
+		if (result)
+		{
+			// Keep the node index stable, the placeholder becomes the compound statement
+			m_AST.SetParent(m_AST[result.Node].Child, node);
+			m_AST.SetType(node, AST::EType::CompoundStatement);
+			m_AST[node].Value = ~0U;
+			m_AST[node].Token = {};
+			m_AST.Free(result.Node);
+		}
+
+		ast = std::move(m_AST);
+		return result;
+	}
+
+	AST::AST State::ParsePipelined(std::string_view source, std::size_t ringCapacity)
+	{
+		Utils::RingBuffer<Tokenizer::Token> ring(ringCapacity);
+		TokenSource                         tokens(ring);
+
+		std::thread tokenizer([source, &ring]() { Tokenizer::Tokenize(source.data(), source.size(), ring); });
+		AST::AST    ast = Parse(source, tokens);
+		// Drain whatever is left so the tokenizer thread can finish if parsing stopped early
+		while (tokens.Request(tokens.Buffered() + 1))
+			tokens.Consume(tokens.Buffered());
+		tokenizer.join();
+		return ast;
+	}
+
+	void State::ReportError(Utils::View<Tokenizer::Token> tokens, std::size_t point, std::string_view message)
 	{
 	}
 
@@ -35,19 +359,119 @@ namespace Frertex::Parser
 		std::size_t depth = 1;
 		while (depth > 0)
 		{
-			auto token = tokens[offset];
+			if (offset >= tokens.size())
+				return ~0ULL;
+
+			auto token = tokens[offset++];
 			if (TestToken(token, open))
 				++depth;
 			else if (TestToken(token, close))
 				--depth;
-			if (++offset > tokens.size())
-				return ~0ULL;
 		}
 		return offset;
 	}
 
+	std::size_t State::FindDeclarationEnd(TokenSource& tokens)
+	{
+		// A declaration ends with a '}' or ';' outside of any brackets, or at the end of the stream
+		std::size_t depth  = 0;
+		std::size_t offset = 0;
+		while (tokens.Request(offset + 1))
+		{
+			auto token = tokens.Window()[offset++];
+			if (token.Class != Tokenizer::ETokenClass::Symbol)
+				continue;
+
+			auto symbol = GetSource(token);
+			if (symbol == "{" || symbol == "(" || symbol == "[[")
+			{
+				++depth;
+			}
+			else if (symbol == "}" || symbol == ")" || symbol == "]]")
+			{
+				if (depth > 0)
+					--depth;
+				if (depth == 0 && symbol == "}")
+					return offset;
+			}
+			else if (depth == 0 && symbol == ";")
+			{
+				return offset;
+			}
+		}
+		return offset;
+	}
+
+	void State::Backtrack(std::uint64_t node)
+	{
+#if FRERTEX_PARSER_PROFILING
+		std::uint64_t size = m_AST.Size();
+		m_AST.FreeFull(node);
+		m_BacktrackedNodes += size - m_AST.Size();
+#else
+		m_AST.FreeFull(node);
+#endif
+	}
+
+	void State::ShiftDeclaration(std::uint64_t node, std::uint64_t tokenDelta, std::uint64_t byteDelta)
+	{
+		// Pre-order without a stack like TypedVisitor::Walk, expressions can nest deeper than recursion allows
+		std::uint64_t current = node;
+		while (true)
+		{
+			AST::Node& value = m_AST[current];
+			if (value.Token.Length != 0)
+				value.Token.Start += byteDelta;
+
+			AST::TokenRange range = m_AST.TokenRangeOf(current);
+			if (range.Count != 0)
+			{
+				range.First += tokenDelta;
+				m_AST.SetTokenRange(current, range);
+			}
+
+			if (value.Child != ~0ULL)
+			{
+				current = value.Child;
+				continue;
+			}
+
+			while (current != node && m_AST[current].NextSibling == ~0ULL)
+				current = m_AST[current].Parent;
+			if (current == node)
+				return;
+			current = m_AST[current].NextSibling;
+		}
+	}
+
+	bool State::StoreIntegerValue(Utils::View<Tokenizer::Token> tokens, std::uint64_t node)
+	{
+		std::uint64_t value;
+		if (!DecodeIntegerLiteral(m_AST[node].Token.Class, GetSource(m_AST[node].Token), value))
+		{
+			ReportError(tokens, m_AST[node].Token.Start, "Integer literal does not fit in 64 bits");
+			return false;
+		}
+		m_AST[node].Value = m_AST.AddInteger(value);
+		return true;
+	}
+
+	bool State::StoreFloatValue(Utils::View<Tokenizer::Token> tokens, std::uint64_t node)
+	{
+		double value;
+		if (!DecodeFloatLiteral(m_AST[node].Token.Class, GetSource(m_AST[node].Token), value, m_LiteralScratch))
+		{
+			ReportError(tokens, m_AST[node].Token.Start, "Malformed float literal");
+			return false;
+		}
+		m_AST[node].Value = m_AST.AddFloat(value);
+		return true;
+	}
+
 	ParseResult State::ParseDeclarations(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Declarations);
+
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::Declarations });
 
 		if (tokens.empty()) return { .UsedTokens = 0, .Node = node };
@@ -77,23 +501,60 @@ namespace Frertex::Parser
 
 		if (firstNode != ~0ULL)
 			m_AST.SetParent(firstNode, node);
-		return { .UsedTokens = usedTokens, .Node = node };
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
+	}
+
+	ParseResult State::ParseDeclarations(TokenSource& tokens)
+	{
+		RuleProfiler profiler(*this, ERule::Declarations);
+
+		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::Declarations });
+
+		std::size_t   usedTokens   = 0;
+		std::uint64_t firstNode    = ~0ULL;
+		std::uint64_t previousNode = ~0ULL;
+
+		while (std::size_t end = FindDeclarationEnd(tokens))
+		{
+			auto window = tokens.Window();
+			auto result = ParseDeclaration({ window.begin(), window.begin() + end });
+			if (!result)
+			{
+				ReportError(window, window[0].Start, "Expected declaration");
+				break;
+			}
+
+			usedTokens += result.UsedTokens;
+			tokens.Consume(result.UsedTokens);
+			if (firstNode == ~0ULL) firstNode = result.Node;
+			if (previousNode != ~0ULL)
+				m_AST.SetSiblings(previousNode, result.Node);
+			previousNode = result.Node;
+		}
+
+		if (firstNode != ~0ULL)
+			m_AST.SetParent(firstNode, node);
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseDeclaration(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Declaration);
+
 		if (tokens.empty())
 			return {};
 
 		auto result = ParseFunctionDeclaration(tokens);
 		if (result)
-			return result;
+			return profiler.Exit(result);
 
 		return {};
 	}
 
 	ParseResult State::ParseFunctionDeclaration(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::FunctionDeclaration);
+
 		if (tokens.empty())
 			return {};
 
@@ -109,7 +570,7 @@ namespace Frertex::Parser
 		result = ParseTypename({ tokens.begin() + usedTokens, tokens.end() });
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
@@ -119,7 +580,7 @@ namespace Frertex::Parser
 		result = ParseIdentifier({ tokens.begin() + usedTokens, tokens.end() });
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
@@ -130,27 +591,35 @@ namespace Frertex::Parser
 		result = ParseParameters({ tokens.begin() + usedTokens, tokens.end() });
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
 		m_AST.SetSiblings(previousNode, result.Node);
 		previousNode = result.Node;
 
-		result = ParseCompoundStatement({ tokens.begin() + usedTokens, tokens.end() });
+		if (m_Options.LazyFunctionBodies)
+			result = ParseLazyCompoundStatement({ tokens.begin() + usedTokens, tokens.end() });
+		else
+			result = ParseCompoundStatement({ tokens.begin() + usedTokens, tokens.end() });
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
 		m_AST.SetSiblings(previousNode, result.Node);
 
-		return { .UsedTokens = usedTokens, .Node = node };
+		if (!m_Tokens.empty())
+			m_AST.SetTokenRange(node, { .First = static_cast<std::uint64_t>(tokens.begin() - m_Tokens.begin()), .Count = usedTokens });
+
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseStatements(Utils::View<Tokenizer::Token> tokens, bool parseFull)
 	{
+		RuleProfiler profiler(*this, ERule::Statements);
+
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::Statements });
 
 		if (tokens.empty()) return { .UsedTokens = 0, .Node = node };
@@ -181,31 +650,39 @@ namespace Frertex::Parser
 
 		m_AST.SetParent(firstNode, node);
 
-		return { .UsedTokens = usedTokens, .Node = node };
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseStatement(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Statement);
+
 		if (tokens.empty())
 			return {};
 
 		auto result = ParseEmptyStatement(tokens);
 		if (result)
-			return result;
+			return profiler.Exit(result);
 
 		result = ParseCompoundStatement(tokens);
 		if (result)
-			return result;
+			return profiler.Exit(result);
 
-		result = ParseDeclaration(tokens);
+		// Decided up front so expression statements never go through a failed declaration attempt
+		if (IsDeclarationStart(tokens))
+			result = ParseDeclaration(tokens);
+		else
+			result = ParseExpressionStatement(tokens);
 		if (result)
-			return result;
+			return profiler.Exit(result);
 
 		return {};
 	}
 
 	ParseResult State::ParseEmptyStatement(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::EmptyStatement);
+
 		if (tokens.empty())
 			return {};
 
@@ -213,15 +690,17 @@ namespace Frertex::Parser
 		if (!TestToken(token, { .Class = Tokenizer::ETokenClass::Symbol, .String = ";" }))
 			return {};
 
-		return {
+		return profiler.Exit({
 			.UsedTokens = 1,
 			.Node       = m_AST.Alloc({ .Type  = AST::EType::EmptyStatement,
 										.Token = token })
-		};
+		});
 	}
 
 	ParseResult State::ParseCompoundStatement(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::CompoundStatement);
+
 		if (tokens.empty())
 			return {};
 
@@ -239,11 +718,230 @@ namespace Frertex::Parser
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::CompoundStatement });
 		m_AST.SetParent(result.Node, node);
 
-		return { .UsedTokens = end, .Node = node };
+		return profiler.Exit({ .UsedTokens = end, .Node = node });
+	}
+
+	ParseResult State::ParseLazyCompoundStatement(Utils::View<Tokenizer::Token> tokens)
+	{
+		RuleProfiler profiler(*this, ERule::LazyCompoundStatement);
+
+		if (tokens.empty())
+			return {};
+
+		if (!TestToken(tokens[0], { .Class = Tokenizer::ETokenClass::Symbol, .String = "{" }))
+			return {};
+		std::size_t end = FindEndToken(tokens,
+									   1,
+									   { .Class = Tokenizer::ETokenClass::Symbol, .String = "{" },
+									   { .Class = Tokenizer::ETokenClass::Symbol, .String = "}" });
+		if (end == ~0ULL)
+			return {};
+
+		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::LazyCompoundStatement, .Token = tokens[0] });
+		m_AST[node].Value  = m_AST.AddTokenRange({ .First = static_cast<std::uint64_t>(tokens.begin() - m_Tokens.begin()), .Count = end });
+
+		return profiler.Exit({ .UsedTokens = end, .Node = node });
+	}
+
+	ParseResult State::ParseExpressionStatement(Utils::View<Tokenizer::Token> tokens)
+	{
+		RuleProfiler profiler(*this, ERule::ExpressionStatement);
+
+		if (tokens.empty())
+			return {};
+
+		auto result = ParseExpression(tokens);
+		if (!result)
+			return {};
+
+		if (result.UsedTokens == tokens.size() || !TestToken(tokens[result.UsedTokens], { .Class = Tokenizer::ETokenClass::Symbol, .String = ";" }))
+		{
+			ReportError(tokens, tokens[result.UsedTokens - 1].Start, "Expected ';' after expression");
+			Backtrack(result.Node);
+			return {};
+		}
+
+		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::ExpressionStatement, .Token = tokens[result.UsedTokens] });
+		m_AST.SetParent(result.Node, node);
+
+		return profiler.Exit({ .UsedTokens = result.UsedTokens + 1, .Node = node });
+	}
+
+	bool State::IsDeclarationStart(Utils::View<Tokenizer::Token> tokens)
+	{
+		// Attributes or a typename followed by an identifier, an expression never has two identifiers in a row
+		if (tokens.empty())
+			return false;
+		if (TestToken(tokens[0], { .Class = Tokenizer::ETokenClass::Symbol, .String = "[[" }))
+			return true;
+
+		std::size_t offset = 0;
+		if (TestToken(tokens[0], { .Class = Tokenizer::ETokenClass::Symbol, .String = "::" }))
+			++offset;
+		while (offset < tokens.size() && tokens[offset].Class == Tokenizer::ETokenClass::Identifier)
+		{
+			if (++offset == tokens.size())
+				return false;
+			if (tokens[offset].Class == Tokenizer::ETokenClass::Identifier)
+				return true;
+			if (!TestToken(tokens[offset], { .Class = Tokenizer::ETokenClass::Symbol, .String = "::" }))
+				return false;
+			++offset;
+		}
+		return false;
+	}
+
+	ParseResult State::ParseExpression(Utils::View<Tokenizer::Token> tokens)
+	{
+		RuleProfiler profiler(*this, ERule::Expression);
+
+		if (tokens.empty())
+			return {};
+
+		// Operator precedence parsing over explicit stacks, so nesting depth costs no recursion and every node is allocated once, when its operator is reduced
+		std::size_t operandBase   = m_Operands.size();
+		std::size_t operatorBase  = m_Operators.size();
+		std::size_t openGroups    = 0;
+		std::size_t usedTokens    = 0;
+		bool        expectOperand = true;
+		bool        failed        = false;
+
+		while (usedTokens < tokens.size())
+		{
+			auto token = tokens[usedTokens];
+			if (expectOperand)
+			{
+				if (token.Class == Tokenizer::ETokenClass::Symbol)
+				{
+					auto symbol = GetSource(token);
+					if (symbol == "(")
+					{
+						m_Operators.emplace_back(PendingOperator { .Operator = AST::EOperator::None, .Precedence = 0, .Token = token });
+						++openGroups;
+						++usedTokens;
+						continue;
+					}
+
+					auto info = FindOperator(c_UnaryOperators, symbol);
+					if (!info)
+					{
+						failed = true;
+						break;
+					}
+					m_Operators.emplace_back(PendingOperator { .Operator = info->Operator, .Precedence = info->Precedence, .Token = token });
+					++usedTokens;
+					continue;
+				}
+
+				auto result = ParseLiteral({ tokens.begin() + usedTokens, tokens.end() });
+				if (!result)
+					result = ParseIdentifier({ tokens.begin() + usedTokens, tokens.end() });
+				if (!result)
+				{
+					failed = true;
+					break;
+				}
+				m_Operands.emplace_back(result.Node);
+				usedTokens    += result.UsedTokens;
+				expectOperand = false;
+				continue;
+			}
+
+			// Behind an operand the expression continues with a call, a ')' closing a group or a binary operator, anything else ends it
+			if (token.Class != Tokenizer::ETokenClass::Symbol)
+				break;
+
+			auto symbol = GetSource(token);
+			if (symbol == "(")
+			{
+				auto result = ParseArguments({ tokens.begin() + usedTokens, tokens.end() });
+				if (!result)
+				{
+					failed = true;
+					break;
+				}
+
+				std::uint64_t callee = m_Operands.back();
+				std::uint64_t node   = m_AST.Alloc({ .Type = AST::EType::CallExpression, .Token = token });
+				m_AST.SetParent(callee, node);
+				m_AST.SetSiblings(callee, result.Node);
+				m_Operands.back() = node;
+				usedTokens        += result.UsedTokens;
+				continue;
+			}
+
+			if (symbol == ")")
+			{
+				if (!openGroups)
+					break;
+				while (m_Operators.back().Operator != AST::EOperator::None)
+					ReduceOperator();
+				m_Operators.pop_back();
+				--openGroups;
+				++usedTokens;
+				continue;
+			}
+
+			auto info = FindOperator(c_BinaryOperators, symbol);
+			if (!info)
+				break;
+			while (m_Operators.size() > operatorBase)
+			{
+				auto& top = m_Operators.back();
+				if (top.Precedence < info->Precedence || (top.Precedence == info->Precedence && info->RightAssociative))
+					break;
+				ReduceOperator();
+			}
+			m_Operators.emplace_back(PendingOperator { .Operator = info->Operator, .Precedence = info->Precedence, .Token = token });
+			++usedTokens;
+			expectOperand = true;
+		}
+
+		if (failed || expectOperand || openGroups)
+		{
+			if (usedTokens < tokens.size())
+				ReportError(tokens, tokens[usedTokens].Start, "Expected expression");
+			for (std::size_t i = operandBase; i < m_Operands.size(); ++i)
+				Backtrack(m_Operands[i]);
+			m_Operands.resize(operandBase);
+			m_Operators.resize(operatorBase);
+			return {};
+		}
+
+		while (m_Operators.size() > operatorBase)
+			ReduceOperator();
+		std::uint64_t node = m_Operands.back();
+		m_Operands.pop_back();
+
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
+	}
+
+	void State::ReduceOperator()
+	{
+		PendingOperator pending = m_Operators.back();
+		m_Operators.pop_back();
+
+		std::uint64_t node = m_AST.Alloc({ .Type  = IsUnaryOperator(pending.Operator) ? AST::EType::UnaryExpression : AST::EType::BinaryExpression,
+										   .Value = static_cast<std::uint32_t>(pending.Operator),
+										   .Token = pending.Token });
+		if (IsUnaryOperator(pending.Operator))
+		{
+			m_AST.SetParent(m_Operands.back(), node);
+		}
+		else
+		{
+			std::uint64_t rhs = m_Operands.back();
+			m_Operands.pop_back();
+			m_AST.SetParent(m_Operands.back(), node);
+			m_AST.SetSiblings(m_Operands.back(), rhs);
+		}
+		m_Operands.back() = node;
 	}
 
 	ParseResult State::ParseParameters(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Parameters);
+
 		if (tokens.empty())
 			return {};
 
@@ -290,11 +988,13 @@ namespace Frertex::Parser
 
 		m_AST.SetParent(firstNode, node);
 
-		return { .UsedTokens = end, .Node = node };
+		return profiler.Exit({ .UsedTokens = end, .Node = node });
 	}
 
 	ParseResult State::ParseParameter(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Parameter);
+
 		if (tokens.empty())
 			return {};
 
@@ -316,7 +1016,7 @@ namespace Frertex::Parser
 		result = ParseTypename({ tokens.begin() + usedTokens, tokens.end() });
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
@@ -326,18 +1026,20 @@ namespace Frertex::Parser
 		result = ParseIdentifier({ tokens.begin() + usedTokens, tokens.end() });
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
 		m_AST.SetSiblings(previousNode, result.Node);
 		m_AST[node].Token = m_AST[result.Node].Token;
 
-		return { .UsedTokens = usedTokens, .Node = node };
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseArguments(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Arguments);
+
 		if (tokens.empty())
 			return {};
 
@@ -346,7 +1048,7 @@ namespace Frertex::Parser
 		std::size_t end = FindEndToken(tokens,
 									   1,
 									   { .Class = Tokenizer::ETokenClass::Symbol, .String = "(" },
-									   { .Class = Tokenizer::ETokenClass::Symbol, .String = "}" });
+									   { .Class = Tokenizer::ETokenClass::Symbol, .String = ")" });
 		if (end == ~0ULL)
 			return {};
 
@@ -373,6 +1075,8 @@ namespace Frertex::Parser
 			if (previousNode != ~0ULL)
 				m_AST.SetSiblings(previousNode, result.Node);
 			previousNode = result.Node;
+			if (itr == endItr)
+				break;
 
 			if (!TestToken(*itr, { .Class = Tokenizer::ETokenClass::Symbol, .String = "," }))
 			{
@@ -382,15 +1086,19 @@ namespace Frertex::Parser
 			++itr;
 		}
 
-		return { .UsedTokens = end, .Node = node };
+		m_AST.SetParent(firstNode, node);
+
+		return profiler.Exit({ .UsedTokens = end, .Node = node });
 	}
 
 	ParseResult State::ParseArgument(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Argument);
+
 		if (tokens.empty())
 			return {};
 
-		auto result = ParseLiteral(tokens);
+		auto result = ParseExpression(tokens);
 		if (!result)
 			return {};
 
@@ -398,24 +1106,26 @@ namespace Frertex::Parser
 		m_AST.SetParent(result.Node, node);
 		m_AST[node].Token = m_AST[result.Node].Token;
 
-		return { .UsedTokens = result.UsedTokens, .Node = node };
+		return profiler.Exit({ .UsedTokens = result.UsedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseAttributes(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Attributes);
+
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::Attributes });
 
 		if (tokens.empty())
-			return { .UsedTokens = 0, .Node = node };
+			return profiler.Exit({ .UsedTokens = 0, .Node = node });
 
 		if (!TestToken(tokens[0], { .Class = Tokenizer::ETokenClass::Symbol, .String = "[[" }))
-			return { .UsedTokens = 0, .Node = node };
+			return profiler.Exit({ .UsedTokens = 0, .Node = node });
 		std::size_t end = FindEndToken(tokens,
 									   1,
 									   { .Class = Tokenizer::ETokenClass::Symbol, .String = "[[" },
 									   { .Class = Tokenizer::ETokenClass::Symbol, .String = "]]" });
 		if (end == ~0ULL)
-			return { .UsedTokens = 0, .Node = node };
+			return profiler.Exit({ .UsedTokens = 0, .Node = node });
 
 		std::size_t   usedTokens   = 0;
 		std::uint64_t firstNode    = ~0ULL;
@@ -438,15 +1148,26 @@ namespace Frertex::Parser
 			if (previousNode != ~0ULL)
 				m_AST.SetSiblings(previousNode, result.Node);
 			previousNode = result.Node;
+			if (itr == endItr)
+				break;
+
+			if (!TestToken(*itr, { .Class = Tokenizer::ETokenClass::Symbol, .String = "," }))
+			{
+				ReportError({ itr, endItr }, itr->Start, "Expected ',' followed by attribute");
+				break;
+			}
+			++itr;
 		}
 
 		m_AST.SetParent(firstNode, node);
 
-		return { .UsedTokens = end, .Node = node };
+		return profiler.Exit({ .UsedTokens = end, .Node = node });
 	}
 
 	ParseResult State::ParseAttribute(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Attribute);
+
 		if (tokens.empty())
 			return {};
 
@@ -458,7 +1179,7 @@ namespace Frertex::Parser
 		auto result = ParseIdentifier(tokens);
 		if (!result)
 		{
-			m_AST.FreeFull(node);
+			Backtrack(node);
 			return {};
 		}
 		usedTokens += result.UsedTokens;
@@ -466,16 +1187,17 @@ namespace Frertex::Parser
 		previousNode      = result.Node;
 		m_AST[node].Token = m_AST[result.Node].Token;
 
-		result     = ParseArguments(tokens);
+		result     = ParseArguments({ tokens.begin() + usedTokens, tokens.end() });
 		usedTokens += result.UsedTokens;
 		m_AST.SetSiblings(previousNode, result.Node);
 
-
-		return { .UsedTokens = usedTokens, .Node = node };
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseTypename(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Typename);
+
 		if (tokens.empty())
 			return {};
 
@@ -509,8 +1231,9 @@ namespace Frertex::Parser
 					return {};
 				}
 			}
-			usedTokens += result.UsedTokens;
+			// The '::' separators count as used, a trailing one does not
 			itr        += result.UsedTokens;
+			usedTokens = itr - tokens.begin();
 			if (firstNode == ~0ULL) firstNode = result.Node;
 			if (previousNode != ~0ULL)
 				m_AST.SetSiblings(previousNode, result.Node);
@@ -528,15 +1251,17 @@ namespace Frertex::Parser
 
 		m_AST.SetParent(firstNode, node);
 
-		return { .UsedTokens = usedTokens, .Node = node };
+		return profiler.Exit({ .UsedTokens = usedTokens, .Node = node });
 	}
 
 	ParseResult State::ParseTypeQualifier(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::TypeQualifier);
+
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::TypeQualifier });
 
 		if (tokens.empty())
-			return { .UsedTokens = 0, .Node = node };
+			return profiler.Exit({ .UsedTokens = 0, .Node = node });
 
 		auto token = tokens[0];
 		if (!TestToken(token, { .Class = Tokenizer::ETokenClass::Identifier, .String = "in" }) &&
@@ -546,71 +1271,79 @@ namespace Frertex::Parser
 
 		m_AST[node].Token = token;
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Literal);
+
 		if (tokens.empty())
 			return {};
 
 		auto result = ParseIntegerLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		result = ParseFloatLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		result = ParseBoolLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		return {};
 	}
 
 	ParseResult State::ParseIntegerLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::IntegerLiteral);
+
 		if (tokens.empty())
 			return {};
 
 		auto result = ParseBinaryIntegerLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		result = ParseOctalIntegerLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		result = ParseDecimalIntegerLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		result = ParseHexIntegerLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		return {};
 	}
 
 	ParseResult State::ParseFloatLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::FloatLiteral);
+
 		if (tokens.empty())
 			return {};
 
 		auto result = ParseDecimalFloatLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		result = ParseHexFloatLiteral(tokens);
-		if (!result)
-			return result;
+		if (result)
+			return profiler.Exit(result);
 
 		return {};
 	}
 
 	ParseResult State::ParseBoolLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::BoolLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -621,12 +1354,15 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::BoolLiteral });
 		m_AST[node].Token  = token;
+		m_AST[node].Value  = GetSource(token) == "true" ? 1 : 0;
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseBinaryIntegerLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::BinaryIntegerLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -636,12 +1372,19 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::IntegerLiteral });
 		m_AST[node].Token  = token;
+		if (!StoreIntegerValue(tokens, node))
+		{
+			Backtrack(node);
+			return {};
+		}
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseOctalIntegerLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::OctalIntegerLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -651,12 +1394,19 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::IntegerLiteral });
 		m_AST[node].Token  = token;
+		if (!StoreIntegerValue(tokens, node))
+		{
+			Backtrack(node);
+			return {};
+		}
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseDecimalIntegerLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::DecimalIntegerLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -666,12 +1416,19 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::IntegerLiteral });
 		m_AST[node].Token  = token;
+		if (!StoreIntegerValue(tokens, node))
+		{
+			Backtrack(node);
+			return {};
+		}
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseHexIntegerLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::HexIntegerLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -681,12 +1438,19 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::IntegerLiteral });
 		m_AST[node].Token  = token;
+		if (!StoreIntegerValue(tokens, node))
+		{
+			Backtrack(node);
+			return {};
+		}
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseDecimalFloatLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::DecimalFloatLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -696,12 +1460,19 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::FloatLiteral });
 		m_AST[node].Token  = token;
+		if (!StoreFloatValue(tokens, node))
+		{
+			Backtrack(node);
+			return {};
+		}
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseHexFloatLiteral(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::HexFloatLiteral);
+
 		if (tokens.empty())
 			return {};
 
@@ -711,12 +1482,19 @@ namespace Frertex::Parser
 
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::FloatLiteral });
 		m_AST[node].Token  = token;
+		if (!StoreFloatValue(tokens, node))
+		{
+			Backtrack(node);
+			return {};
+		}
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 
 	ParseResult State::ParseIdentifier(Utils::View<Tokenizer::Token> tokens)
 	{
+		RuleProfiler profiler(*this, ERule::Identifier);
+
 		if (tokens.empty())
 			return {};
 
@@ -726,6 +1504,6 @@ namespace Frertex::Parser
 		std::uint64_t node = m_AST.Alloc({ .Type = AST::EType::Identifier });
 		m_AST[node].Token  = tokens[0];
 
-		return { .UsedTokens = 1, .Node = node };
+		return profiler.Exit({ .UsedTokens = 1, .Node = node });
 	}
 } // namespace Frertex::Parser
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "Frertex/Parser/TokenSource.h"
+
+namespace Frertex::Parser
+{
+	static constexpr std::size_t c_PullSize = 256;
+
+	TokenSource::TokenSource(Utils::RingBuffer<Tokenizer::Token>& ring)
+		: m_Ring(&ring),
+		  m_Offset(0),
+		  m_Ended(false)
+	{
+	}
+
+	bool TokenSource::Request(std::size_t count)
+	{
+		while (Buffered() < count)
+		{
+			if (m_Ended)
+				return false;
+
+			// Drop consumed tokens before growing, keeps the buffer at roughly the size of one declaration
+			if (m_Offset > 0 && m_Offset >= Buffered())
+			{
+				m_Tokens.erase(m_Tokens.begin(), m_Tokens.begin() + m_Offset);
+				m_Offset = 0;
+			}
+
+			std::size_t previousSize = m_Tokens.size();
+			m_Tokens.resize(previousSize + c_PullSize);
+			std::size_t pulled = m_Ring->Pop(m_Tokens.data() + previousSize, c_PullSize);
+			m_Tokens.resize(previousSize + pulled);
+			m_Ended = pulled == 0;
+		}
+		return true;
+	}
+
+	void TokenSource::Consume(std::size_t count)
+	{
+		m_Offset += count < Buffered() ? count : Buffered();
+	}
+} // namespace Frertex::Parser
@@ -0,0 +1,78 @@
+#include "Frertex/Tokenizer/SourceMap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace Frertex::Tokenizer
+{
+	static constexpr std::uint64_t c_NewlineBytes = 0x0A0A'0A0A'0A0A'0A0AULL;
+	static constexpr std::uint64_t c_LowBits      = 0x7F7F'7F7F'7F7F'7F7FULL;
+
+	static std::uint64_t NewlineMask(std::uint64_t word)
+	{
+		// Exact per byte, sets the high bit of every byte equal to '\n'
+		std::uint64_t x = word ^ c_NewlineBytes;
+		return ~(((x & c_LowBits) + c_LowBits) | x | c_LowBits);
+	}
+
+	SourceMap::SourceMap()
+		: m_LineStarts(1, 0) {}
+
+	void SourceMap::Reset()
+	{
+		m_LineStarts.clear();
+		m_LineStarts.emplace_back(0);
+	}
+
+	void SourceMap::Build(const void* data, std::size_t size)
+	{
+		Reset();
+		ScanNewlines(data, 0, size);
+	}
+
+	void SourceMap::ScanNewlines(const void* data, std::size_t begin, std::size_t end)
+	{
+		const std::uint8_t* pChars = reinterpret_cast<const std::uint8_t*>(data);
+
+		std::size_t offset = begin;
+		for (; offset + 8 <= end; offset += 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, pChars + offset, 8);
+			std::uint64_t mask = NewlineMask(word);
+			while (mask)
+			{
+				std::size_t byte;
+				if constexpr (std::endian::native == std::endian::little)
+				{
+					byte = std::countr_zero(mask) >> 3;
+					mask &= mask - 1;
+				}
+				else
+				{
+					byte = std::countl_zero(mask) >> 3;
+					mask &= ~(0x80ULL << ((7 - byte) << 3));
+				}
+				m_LineStarts.emplace_back(offset + byte + 1);
+			}
+		}
+		for (; offset < end; ++offset)
+			if (pChars[offset] == '\n')
+				m_LineStarts.emplace_back(offset + 1);
+	}
+
+	SourceLocation SourceMap::LineColumn(std::uint64_t offset) const
+	{
+		auto          itr  = std::upper_bound(m_LineStarts.begin(), m_LineStarts.end(), offset);
+		std::uint64_t line = static_cast<std::uint64_t>(itr - m_LineStarts.begin());
+		return { .Line = line, .Column = offset - m_LineStarts[line - 1] + 1 };
+	}
+
+	std::uint64_t SourceMap::LineStart(std::uint64_t line) const
+	{
+		if (line == 0 || line > m_LineStarts.size())
+			return ~0ULL;
+		return m_LineStarts[line - 1];
+	}
+} // namespace Frertex::Tokenizer
\ No newline at end of file
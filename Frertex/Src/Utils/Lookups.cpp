@@ -0,0 +1,65 @@
+// Auto generated
+
+#include "Frertex/Utils/Lookups.h"
+
+namespace Frertex::Utils::Lookups
+{
+	// Has to match the Generator, the tables below are only perfect for exactly this hash
+	static std::uint64_t Mix(std::uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58'476D'1CE4'E5B9ULL;
+		value ^= value >> 27;
+		value *= 0x94D0'49BB'1331'11EBULL;
+		value ^= value >> 31;
+		return value;
+	}
+
+	static std::uint64_t Hash(std::string_view str)
+	{
+		std::uint64_t hash = 0xCBF2'9CE4'8422'2325ULL;
+		for (char c : str)
+			hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x0000'0100'0000'01B3ULL;
+		return Mix(hash);
+	}
+
+	static std::uint32_t Reduce(std::uint64_t value, std::uint32_t range)
+	{
+		return static_cast<std::uint32_t>(((value >> 32) * range) >> 32);
+	}
+
+	static std::uint32_t Slot(std::uint64_t hash, std::uint32_t displacement, std::uint32_t count)
+	{
+		return Reduce(Mix(hash ^ displacement), count);
+	}
+
+	std::uint32_t FindEntrypointType(std::string_view str)
+	{
+		static constexpr std::uint32_t c_Displacements[7] { 0, 0, 2, 3, 1, 99, 16 };
+		static constexpr std::uint32_t c_Slots[14] { 9, 7, 4, 6, 12, 3, 11, 5, 2, 8, 1, 13, 0, 10 };
+
+		std::uint64_t hash  = Hash(str);
+		std::uint32_t index = c_Slots[Slot(hash, c_Displacements[Reduce(hash, 7)], 14)];
+		return c_EntrypointTypeNames[index] == str ? index : c_NotFound;
+	}
+
+	std::uint32_t FindTypeQualifier(std::string_view str)
+	{
+		static constexpr std::uint32_t c_Displacements[2] { 2, 3 };
+		static constexpr std::uint32_t c_Slots[3] { 2, 1, 0 };
+
+		std::uint64_t hash  = Hash(str);
+		std::uint32_t index = c_Slots[Slot(hash, c_Displacements[Reduce(hash, 2)], 3)];
+		return c_TypeQualifierNames[index] == str ? index : c_NotFound;
+	}
+
+	std::uint32_t FindAttribute(std::string_view str)
+	{
+		static constexpr std::uint32_t c_Displacements[8] { 2, 0, 9, 4, 4, 1, 10, 1 };
+		static constexpr std::uint32_t c_Slots[15] { 9, 11, 1, 3, 12, 6, 8, 14, 4, 7, 2, 5, 13, 0, 10 };
+
+		std::uint64_t hash  = Hash(str);
+		std::uint32_t index = c_Slots[Slot(hash, c_Displacements[Reduce(hash, 8)], 15)];
+		return c_AttributeNames[index] == str ? index : c_NotFound;
+	}
+} // namespace Frertex::Utils::Lookups
\ No newline at end of file
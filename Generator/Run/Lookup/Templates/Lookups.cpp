@@ -0,0 +1,37 @@
+// Auto generated
+
+#include "Frertex/Utils/Lookups.h"
+
+namespace Frertex::Utils::Lookups
+{
+	// Has to match the Generator, the tables below are only perfect for exactly this hash
+	static std::uint64_t Mix(std::uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58'476D'1CE4'E5B9ULL;
+		value ^= value >> 27;
+		value *= 0x94D0'49BB'1331'11EBULL;
+		value ^= value >> 31;
+		return value;
+	}
+
+	static std::uint64_t Hash(std::string_view str)
+	{
+		std::uint64_t hash = 0xCBF2'9CE4'8422'2325ULL;
+		for (char c : str)
+			hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x0000'0100'0000'01B3ULL;
+		return Mix(hash);
+	}
+
+	static std::uint32_t Reduce(std::uint64_t value, std::uint32_t range)
+	{
+		return static_cast<std::uint32_t>(((value >> 32) * range) >> 32);
+	}
+
+	static std::uint32_t Slot(std::uint64_t hash, std::uint32_t displacement, std::uint32_t count)
+	{
+		return Reduce(Mix(hash ^ displacement), count);
+	}
+
+	$DEFINITIONS$
+} // namespace Frertex::Utils::Lookups
\ No newline at end of file
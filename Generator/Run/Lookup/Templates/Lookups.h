@@ -0,0 +1,14 @@
+// Auto generated
+
+#pragma once
+
+#include <cstdint>
+
+#include <string_view>
+
+namespace Frertex::Utils::Lookups
+{
+	static constexpr std::uint32_t c_NotFound = ~0U;
+
+	$DECLARATIONS$
+} // namespace Frertex::Utils::Lookups
\ No newline at end of file
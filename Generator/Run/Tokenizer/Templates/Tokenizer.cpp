@@ -2,16 +2,37 @@
 
 #include "Frertex/Tokenizer/Tokenizer.h"
 
+#include <algorithm>
+#include <array>
+
 namespace Frertex::Tokenizer
 {
 	static constexpr $TYPE$ ResultStateStep  = 0x01;
 	static constexpr $TYPE$ ResultStateEnd   = 0x02;
 	static constexpr $TYPE$ ResultStateError = 0x04;
 
+	static constexpr std::size_t c_NewlineScanAhead = 256;
+	static constexpr std::size_t c_MaxStreams       = 4;
+	static constexpr std::size_t c_MinStreamSize    = 4096;
+	static constexpr std::size_t c_EmitBlockSize    = 4096;
+	static constexpr std::size_t c_RingBatchSize    = 256;
+
 	extern ECharacterClass c_CharacterClasses[$CHARCLASSESCOUNT$];
 	extern bool            c_IncludedTokenClasses[$TOKENCLASSCOUNT$];
 	extern $TYPE$          c_TokenLUT[$TOKENLUTSIZE$];
 
+	struct TokenizerStream
+	{
+	public:
+		const $CHARTYPE$*   Chars;
+		std::size_t         TokenStart;
+		std::size_t         End;
+		std::uint32_t       TokenLength;
+		$TYPE$              CurState;
+		std::size_t         Iterations;
+		std::vector<Token>* Tokens;
+	};
+
 	void AddToken($TYPE$ state, std::size_t& start, std::uint32_t& length, std::vector<Token>& tokens)
 	{
 		if (!length)
@@ -57,4 +78,310 @@ namespace Frertex::Tokenizer
 		AddToken(curState, tokenStart, tokenLength, tokens);
 		return iters;
 	}
+
+	std::size_t Tokenize(const void* data, std::size_t size, std::vector<Token>& tokens, SourceMap& sourceMap)
+	{
+		sourceMap.Reset();
+		if (!data || !size)
+			return 0;
+
+		const $CHARTYPE$* pChars = reinterpret_cast<const $CHARTYPE$*>(data);
+		size                     /= sizeof($CHARTYPE$);
+
+		$TYPE$        curState    = ((static_cast<$TYPE$>(ETokenClass::$INITIALTOKENCLASS$) << $TOKENCLASSBIT$) & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+		std::size_t   tokenStart  = 0;
+		std::uint32_t tokenLength = 0;
+		std::size_t   scanned     = 0;
+
+		std::size_t iters = 0;
+		while (tokenStart < size)
+		{
+			++iters;
+			$TYPE$ result    = c_TokenLUT[curState];
+			$TYPE$ charState = result >> $CHARBIT$;
+			$TYPE$ step      = charState & ResultStateStep;
+			pChars           += step;
+			tokenLength      += step;
+			if (charState & ResultStateEnd)
+			{
+				AddToken(curState, tokenStart, tokenLength, tokens);
+				if (tokenStart >= scanned)
+				{
+					std::size_t scanEnd = std::min<std::size_t>(tokenStart + c_NewlineScanAhead, size);
+					sourceMap.ScanNewlines(data, scanned, scanEnd);
+					scanned = scanEnd;
+				}
+			}
+			curState = (result & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+		}
+		AddToken(curState, tokenStart, tokenLength, tokens);
+		if (scanned < size)
+			sourceMap.ScanNewlines(data, scanned, size);
+		return iters;
+	}
+
+	std::size_t Tokenize(const void* data, std::size_t size, Utils::RingBuffer<Token>& ring)
+	{
+		if (!data || !size)
+		{
+			ring.Close();
+			return 0;
+		}
+
+		const $CHARTYPE$* pChars = reinterpret_cast<const $CHARTYPE$*>(data);
+		size                     /= sizeof($CHARTYPE$);
+
+		$TYPE$        curState    = ((static_cast<$TYPE$>(ETokenClass::$INITIALTOKENCLASS$) << $TOKENCLASSBIT$) & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+		std::size_t   tokenStart  = 0;
+		std::uint32_t tokenLength = 0;
+
+		std::vector<Token> batch;
+		batch.reserve(c_RingBatchSize);
+
+		std::size_t iters = 0;
+		while (tokenStart < size)
+		{
+			++iters;
+			$TYPE$ result    = c_TokenLUT[curState];
+			$TYPE$ charState = result >> $CHARBIT$;
+			$TYPE$ step      = charState & ResultStateStep;
+			pChars           += step;
+			tokenLength      += step;
+			if (charState & ResultStateEnd)
+			{
+				AddToken(curState, tokenStart, tokenLength, batch);
+				if (batch.size() >= c_RingBatchSize)
+				{
+					ring.Push(batch.data(), batch.size());
+					batch.clear();
+				}
+			}
+			curState = (result & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+		}
+		AddToken(curState, tokenStart, tokenLength, batch);
+		ring.Push(batch.data(), batch.size());
+		ring.Close();
+		return iters;
+	}
+
+	std::size_t TokenizeBranchless(const void* data, std::size_t size, std::vector<Token>& tokens)
+	{
+		if (!data || !size)
+			return 0;
+
+		const $CHARTYPE$* pChars = reinterpret_cast<const $CHARTYPE$*>(data);
+		size                     /= sizeof($CHARTYPE$);
+
+		$TYPE$        curState    = ((static_cast<$TYPE$>(ETokenClass::$INITIALTOKENCLASS$) << $TOKENCLASSBIT$) & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+		std::size_t   tokenStart  = 0;
+		std::uint32_t tokenLength = 0;
+		std::size_t   count       = tokens.size();
+
+		std::size_t iters = 0;
+		while (tokenStart < size)
+		{
+			// Every iteration ends at most one token, so a block can never write past the slots reserved for it
+			tokens.resize(count + c_EmitBlockSize);
+			Token*      pTokens = tokens.data();
+			std::size_t i       = 0;
+			for (; i < c_EmitBlockSize && tokenStart < size; ++i)
+			{
+				$TYPE$ result     = c_TokenLUT[curState];
+				$TYPE$ charState  = result >> $CHARBIT$;
+				$TYPE$ step       = charState & ResultStateStep;
+				$TYPE$ tokenClass = (curState & $TOKENCLASSMASK$) >> $TOKENCLASSBIT$;
+				pChars            += step;
+				tokenLength       += step;
+
+				std::uint32_t end     = (charState & ResultStateEnd) != 0;
+				std::uint32_t endMask = 0U - end;
+				pTokens[count]        = Token { .Class = static_cast<ETokenClass>(tokenClass), .Length = tokenLength, .Start = tokenStart };
+				count                 += end & c_IncludedTokenClasses[tokenClass] & (tokenLength != 0);
+				tokenStart            += tokenLength & endMask;
+				tokenLength           &= ~endMask;
+				curState              = (result & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+			}
+			iters += i;
+		}
+		tokens.resize(count);
+		AddToken(curState, tokenStart, tokenLength, tokens);
+		return iters;
+	}
+
+	static inline void StepStream(TokenizerStream& stream)
+	{
+		++stream.Iterations;
+		$TYPE$ result    = c_TokenLUT[stream.CurState];
+		$TYPE$ charState = result >> $CHARBIT$;
+		$TYPE$ step      = charState & ResultStateStep;
+		stream.Chars       += step;
+		stream.TokenLength += step;
+		if (charState & ResultStateEnd)
+			AddToken(stream.CurState, stream.TokenStart, stream.TokenLength, *stream.Tokens);
+		stream.CurState = (result & ~$CHARMASK$) | (static_cast<$TYPE$>(*stream.Chars) << $CHARBIT$);
+	}
+
+	template <std::size_t N>
+	static void InterleaveStreams(TokenizerStream* streams)
+	{
+		bool active = true;
+		while (active)
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				StepStream(streams[i]);
+				active &= streams[i].TokenStart < streams[i].End;
+			}
+		}
+	}
+
+	std::size_t TokenizeInterleaved(const void* data, std::size_t size, std::vector<Token>& tokens, std::size_t streamCount)
+	{
+		if (!data || !size)
+			return 0;
+
+		streamCount = std::clamp<std::size_t>(streamCount, 1, c_MaxStreams);
+		if (streamCount < 2 || size / sizeof($CHARTYPE$) < streamCount * c_MinStreamSize)
+			return Tokenize(data, size, tokens);
+
+		const $CHARTYPE$* pChars = reinterpret_cast<const $CHARTYPE$*>(data);
+		size                     /= sizeof($CHARTYPE$);
+
+		// Split at newlines, the state machine is almost always in its initial state after one
+		std::array<std::size_t, c_MaxStreams + 1> bounds {};
+		std::size_t                               segments = 1;
+		for (std::size_t i = 1; i < streamCount; ++i)
+		{
+			std::size_t target = std::max(size * i / streamCount, bounds[segments - 1]);
+			std::size_t split  = std::find(pChars + target, pChars + size, '\n') - pChars + 1;
+			if (split >= size)
+				break;
+			bounds[segments++] = split;
+		}
+		bounds[segments] = size;
+
+		$TYPE$ initialState = (static_cast<$TYPE$>(ETokenClass::$INITIALTOKENCLASS$) << $TOKENCLASSBIT$) & ~$CHARMASK$;
+
+		std::array<std::vector<Token>, c_MaxStreams> segmentTokens;
+		std::array<TokenizerStream, c_MaxStreams>    streams {};
+		for (std::size_t i = 0; i < segments; ++i)
+		{
+			streams[i] = {
+				.Chars       = pChars + bounds[i],
+				.TokenStart  = bounds[i],
+				.End         = bounds[i + 1],
+				.TokenLength = 0,
+				.CurState    = static_cast<$TYPE$>(initialState | (static_cast<$TYPE$>(pChars[bounds[i]]) << $CHARBIT$)),
+				.Iterations  = 0,
+				.Tokens      = i == 0 ? &tokens : &segmentTokens[i]
+			};
+		}
+
+		switch (segments)
+		{
+		case 2: InterleaveStreams<2>(streams.data()); break;
+		case 3: InterleaveStreams<3>(streams.data()); break;
+		case 4: InterleaveStreams<4>(streams.data()); break;
+		default: break;
+		}
+
+		// Merge segments in order, a segment is only kept if the previous one ended exactly at its start in the initial state
+		TokenizerStream* current = &streams[0];
+		while (current->TokenStart < current->End)
+			StepStream(*current);
+		std::size_t iters = current->Iterations;
+		for (std::size_t i = 1; i < segments; ++i)
+		{
+			TokenizerStream& next = streams[i];
+			while (next.TokenStart < next.End)
+				StepStream(next);
+			iters += next.Iterations;
+
+			if (current->TokenStart == bounds[i] && (current->CurState & ~$CHARMASK$) == initialState)
+			{
+				tokens.insert(tokens.end(), segmentTokens[i].begin(), segmentTokens[i].end());
+				next.Tokens = &tokens;
+				current     = &next;
+			}
+			else
+			{
+				std::size_t previousIters = current->Iterations;
+				current->End              = next.End;
+				while (current->TokenStart < current->End)
+					StepStream(*current);
+				iters += current->Iterations - previousIters;
+			}
+		}
+		AddToken(current->CurState, current->TokenStart, current->TokenLength, tokens);
+		return iters;
+	}
+
+	RetokenizeResult Retokenize(const void* data, std::size_t size, std::vector<Token>& tokens, const Edit& edit)
+	{
+		RetokenizeResult result {};
+		if (!data || !size)
+		{
+			result.RemovedTokens = tokens.size();
+			tokens.clear();
+			return result;
+		}
+
+		const $CHARTYPE$* pChars = reinterpret_cast<const $CHARTYPE$*>(data);
+		size                     /= sizeof($CHARTYPE$);
+
+		// Restart at the token before the edit, everything before it is unaffected
+		auto        endsBefore = [&](const Token& token) { return token.Start + token.Length < edit.Offset; };
+		std::size_t next       = std::partition_point(tokens.begin(), tokens.end(), endsBefore) - tokens.begin();
+		std::size_t first      = next > 0 ? next - 1 : 0;
+		std::size_t tokenStart = next > 0 ? tokens[first].Start : 0;
+
+		// Old tokens past the removed range are candidates for resynchronization
+		auto          startsBefore = [&](const Token& token) { return token.Start < edit.Offset + edit.RemovedLength; };
+		std::size_t   old          = std::partition_point(tokens.begin() + first, tokens.end(), startsBefore) - tokens.begin();
+		std::uint64_t delta        = edit.InsertedLength - edit.RemovedLength;
+		std::uint64_t editEnd      = edit.Offset + edit.InsertedLength;
+
+		pChars += tokenStart;
+
+		$TYPE$ initialState = (static_cast<$TYPE$>(ETokenClass::$INITIALTOKENCLASS$) << $TOKENCLASSBIT$) & ~$CHARMASK$;
+		$TYPE$ curState     = static_cast<$TYPE$>(initialState | (static_cast<$TYPE$>(*pChars) << $CHARBIT$));
+
+		std::vector<Token> newTokens;
+		std::uint32_t      tokenLength = 0;
+		while (tokenStart < size)
+		{
+			++result.Iterations;
+			$TYPE$ lutResult = c_TokenLUT[curState];
+			$TYPE$ charState = lutResult >> $CHARBIT$;
+			$TYPE$ step      = charState & ResultStateStep;
+			pChars           += step;
+			tokenLength      += step;
+			if (charState & ResultStateEnd)
+				AddToken(curState, tokenStart, tokenLength, newTokens);
+			curState = (lutResult & ~$CHARMASK$) | (static_cast<$TYPE$>(*pChars) << $CHARBIT$);
+
+			if ((charState & ResultStateEnd) && tokenStart >= editEnd && (curState & ~$CHARMASK$) == initialState)
+			{
+				while (old < tokens.size() && tokens[old].Start + delta < tokenStart)
+					++old;
+				if (old < tokens.size() && tokens[old].Start + delta == tokenStart)
+					break;
+			}
+		}
+		if (tokenStart >= size)
+		{
+			AddToken(curState, tokenStart, tokenLength, newTokens);
+			old = tokens.size();
+		}
+
+		for (std::size_t i = old; i < tokens.size(); ++i)
+			tokens[i].Start += delta;
+		tokens.erase(tokens.begin() + first, tokens.begin() + old);
+		tokens.insert(tokens.begin() + first, newTokens.begin(), newTokens.end());
+
+		result.FirstToken     = first;
+		result.RemovedTokens  = old - first;
+		result.InsertedTokens = newTokens.size();
+		return result;
+	}
 } // namespace Frertex::Tokenizer
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "Lookup.h"
+#include "Utils/Format.h"
+
+#include <cctype>
+#include <cstdint>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct LookupTable
+{
+	std::string              Name;
+	std::vector<std::string> Keys;
+};
+
+// Hash, Reduce and Slot have to match Lookup/Templates/Lookups.cpp
+static std::uint64_t Mix(std::uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xBF58'476D'1CE4'E5B9ULL;
+	value ^= value >> 27;
+	value *= 0x94D0'49BB'1331'11EBULL;
+	value ^= value >> 31;
+	return value;
+}
+
+static std::uint64_t Hash(std::string_view str)
+{
+	std::uint64_t hash = 0xCBF2'9CE4'8422'2325ULL;
+	for (char c : str)
+		hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x0000'0100'0000'01B3ULL;
+	return Mix(hash);
+}
+
+static std::uint32_t Reduce(std::uint64_t value, std::uint32_t range)
+{
+	return static_cast<std::uint32_t>(((value >> 32) * range) >> 32);
+}
+
+static std::uint32_t Slot(std::uint64_t hash, std::uint32_t displacement, std::uint32_t count)
+{
+	return Reduce(Mix(hash ^ displacement), count);
+}
+
+static bool ParseLookups(std::string_view source, std::vector<LookupTable>& tables)
+{
+	// Name { Key Key ... }, '#' comments until the end of the line
+	LookupTable* table = nullptr;
+	std::size_t  i     = 0;
+	while (i < source.size())
+	{
+		char c = source[i];
+		if (std::isspace(static_cast<unsigned char>(c)))
+		{
+			++i;
+			continue;
+		}
+		if (c == '#')
+		{
+			while (i < source.size() && source[i] != '\n')
+				++i;
+			continue;
+		}
+		if (c == '{' || c == '}')
+		{
+			if ((c == '{') == (table != nullptr) || (c == '{' && tables.empty()))
+			{
+				std::cerr << "Unexpected '" << c << "' in 'Lookup/Lookups.txt'\n";
+				return false;
+			}
+			table = c == '{' ? &tables.back() : nullptr;
+			++i;
+			continue;
+		}
+
+		std::size_t start = i;
+		while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'))
+			++i;
+		if (i == start)
+		{
+			std::cerr << "Unexpected '" << c << "' in 'Lookup/Lookups.txt'\n";
+			return false;
+		}
+		std::string word { source.substr(start, i - start) };
+		if (table)
+			table->Keys.emplace_back(std::move(word));
+		else
+			tables.push_back({ .Name = std::move(word), .Keys = {} });
+	}
+	if (table)
+	{
+		std::cerr << "Missing '}' in 'Lookup/Lookups.txt'\n";
+		return false;
+	}
+	return true;
+}
+
+// Hash and displace: keys are hashed into buckets of about two keys, then buckets from largest to smallest search for a displacement that moves all their keys into free slots.
+// There are exactly as many slots as keys, so the table is minimal, and a lookup is one hash, two table reads and the verification compare.
+static bool BuildPerfectHash(const LookupTable& table, std::vector<std::uint32_t>& displacements, std::vector<std::uint32_t>& slots)
+{
+	std::uint32_t count       = static_cast<std::uint32_t>(table.Keys.size());
+	std::uint32_t bucketCount = std::max<std::uint32_t>(1, (count + 1) / 2);
+
+	std::vector<std::uint64_t>              hashes(count);
+	std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+	for (std::uint32_t i = 0; i < count; ++i)
+	{
+		hashes[i] = Hash(table.Keys[i]);
+		for (std::uint32_t j = 0; j < i; ++j)
+		{
+			if (hashes[j] == hashes[i])
+			{
+				std::cerr << "'" << table.Keys[i] << "' collides with '" << table.Keys[j] << "' in lookup '" << table.Name << "'\n";
+				return false;
+			}
+		}
+		buckets[Reduce(hashes[i], bucketCount)].push_back(i);
+	}
+
+	std::vector<std::uint32_t> order(bucketCount);
+	for (std::uint32_t i = 0; i < bucketCount; ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+	displacements.assign(bucketCount, 0);
+	slots.assign(count, ~0U);
+	std::vector<std::uint32_t> taken;
+	for (std::uint32_t bucket : order)
+	{
+		auto& keys = buckets[bucket];
+		if (keys.empty())
+			break;
+
+		bool placed = false;
+		for (std::uint32_t displacement = 0; displacement < (1U << 24) && !placed; ++displacement)
+		{
+			taken.clear();
+			placed = true;
+			for (std::uint32_t key : keys)
+			{
+				std::uint32_t slot = Slot(hashes[key], displacement, count);
+				if (slots[slot] != ~0U || std::find(taken.begin(), taken.end(), slot) != taken.end())
+				{
+					placed = false;
+					break;
+				}
+				taken.push_back(slot);
+			}
+			if (!placed)
+				continue;
+
+			displacements[bucket] = displacement;
+			for (std::size_t i = 0; i < keys.size(); ++i)
+				slots[taken[i]] = keys[i];
+		}
+		if (!placed)
+		{
+			std::cerr << "Failed to find a perfect hash for lookup '" << table.Name << "'\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+static std::string JoinNumbers(const std::vector<std::uint32_t>& numbers)
+{
+	std::string result;
+	for (std::size_t i = 0; i < numbers.size(); ++i)
+	{
+		if (i > 0)
+			result += ", ";
+		result += std::to_string(numbers[i]);
+	}
+	return result;
+}
+
+void GenerateLookups()
+{
+	std::string lookupsSource;
+	{
+		std::ifstream file("Lookup/Lookups.txt", std::ios::ate | std::ios::binary);
+		if (!file)
+		{
+			std::cerr << "Failed to open 'Lookup/Lookups.txt'\n";
+			return;
+		}
+		lookupsSource.resize(file.tellg());
+		file.seekg(0);
+		file.read(lookupsSource.data(), lookupsSource.size());
+		file.close();
+	}
+	std::vector<LookupTable> tables;
+	if (!ParseLookups(lookupsSource, tables))
+		return;
+
+	std::string declarationsStr;
+	std::string definitionsStr;
+	for (auto& table : tables)
+	{
+		if (table.Keys.empty())
+		{
+			std::cerr << "Lookup '" << table.Name << "' has no keys\n";
+			return;
+		}
+
+		std::vector<std::uint32_t> displacements;
+		std::vector<std::uint32_t> slots;
+		if (!BuildPerfectHash(table, displacements, slots))
+			return;
+
+		std::string count = std::to_string(table.Keys.size());
+		std::string names;
+		for (std::size_t i = 0; i < table.Keys.size(); ++i)
+		{
+			if (i > 0)
+				names += ", ";
+			names += "\"" + table.Keys[i] + "\"";
+		}
+
+		if (!declarationsStr.empty())
+			declarationsStr += "\n\n\t";
+		declarationsStr += "static constexpr std::string_view c_" + table.Name + "Names[" + count + "] { " + names + " };\n";
+		declarationsStr += "\t// Index of 'str' in c_" + table.Name + "Names, c_NotFound if it is not one of them\n";
+		declarationsStr += "\tstd::uint32_t Find" + table.Name + "(std::string_view str);";
+
+		if (!definitionsStr.empty())
+			definitionsStr += "\n\n\t";
+		definitionsStr += "std::uint32_t Find" + table.Name + "(std::string_view str)\n\t{\n";
+		definitionsStr += "\t\tstatic constexpr std::uint32_t c_Displacements[" + std::to_string(displacements.size()) + "] { " + JoinNumbers(displacements) + " };\n";
+		definitionsStr += "\t\tstatic constexpr std::uint32_t c_Slots[" + count + "] { " + JoinNumbers(slots) + " };\n\n";
+		definitionsStr += "\t\tstd::uint64_t hash  = Hash(str);\n";
+		definitionsStr += "\t\tstd::uint32_t index = c_Slots[Slot(hash, c_Displacements[Reduce(hash, " + std::to_string(displacements.size()) + ")], " + count + ")];\n";
+		definitionsStr += "\t\treturn c_" + table.Name + "Names[index] == str ? index : c_NotFound;\n\t}";
+	}
+
+	std::vector<std::pair<std::string, std::string>> replacements {
+		{"DECLARATIONS", declarationsStr},
+		{ "DEFINITIONS", definitionsStr },
+	};
+
+	std::vector<std::pair<std::string, std::string>> templates {
+		{"Lookup/Templates/Lookups.h",    "Lookup/Out/Inc/Frertex/Utils/Lookups.h"},
+		{ "Lookup/Templates/Lookups.cpp", "Lookup/Out/Src/Utils/Lookups.cpp"      },
+	};
+	GenerateTemplates(templates, replacements);
+}
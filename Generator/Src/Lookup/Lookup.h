@@ -0,0 +1,3 @@
+#pragma once
+
+void GenerateLookups();
\ No newline at end of file
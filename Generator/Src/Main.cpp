@@ -1,7 +1,9 @@
+#include "Lookup/Lookup.h"
 #include "Tokenizer/Tokenizer.h"
 
 int main(int argc, char** argv)
 {
 	GenerateTokenizer();
+	GenerateLookups();
 	return 0;
 }
\ No newline at end of file
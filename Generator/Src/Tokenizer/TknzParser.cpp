@@ -86,7 +86,7 @@ static std::uint64_t GetCharValue(std::string_view str)
 		case 'f': return 12;
 		case 'r': return 13;
 		case 'u': return std::strtoull(str.data() + 2, nullptr, 16);
-		default: return 0;
+		default: return static_cast<std::uint64_t>(str[1]);
 		}
 	default:
 		return static_cast<std::uint64_t>(str[0]);
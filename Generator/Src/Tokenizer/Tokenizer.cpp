@@ -1,5 +1,6 @@
 #include "Tokenizer.h"
 #include "TknzParser.h"
+#include "Utils/Format.h"
 
 #include <cctype>
 #include <cstdint>
@@ -39,33 +40,6 @@ static std::string_view CharacterClassToString(ECharacterClass clazz)
 	}
 }
 
-std::string FormatStr(std::string_view format, const std::vector<std::pair<std::string, std::string>>& replacements)
-{
-	std::string result;
-	std::size_t offset = 0;
-	while (offset < format.size())
-	{
-		std::size_t replacementStart = format.find_first_of('$', offset);
-		if (replacementStart == std::string::npos) break;
-		std::size_t replacementEnd = format.find_first_of('$', replacementStart + 1);
-		if (replacementEnd == std::string::npos) break;
-		std::string_view replacementID = format.substr(replacementStart + 1, replacementEnd - replacementStart - 1);
-		result                         += format.substr(offset, replacementStart - offset);
-		offset                         = replacementEnd + 1;
-		for (auto& repl : replacements)
-		{
-			if (repl.first == replacementID)
-			{
-				result += repl.second;
-				break;
-			}
-		}
-	}
-	if (offset < format.size())
-		result += format.substr(offset);
-	return result;
-}
-
 void GenerateTokenizer()
 {
 	std::string tknzSource;
@@ -198,34 +172,5 @@ void GenerateTokenizer()
 		{ "Tokenizer/Templates/LUTs.cpp",      "Tokenizer/Out/Src/Tokenizer/LUTs.cpp"       },
 		{ "Tokenizer/Templates/Tokenizer.cpp", "Tokenizer/Out/Src/Tokenizer/Tokenizer.cpp"  },
 	};
-	for (auto& tmpl : templates)
-	{
-		std::string format;
-		{
-			std::ifstream file(tmpl.first, std::ios::ate);
-			if (!file)
-			{
-				std::cerr << "Failed to open '" << tmpl.first << "'\n";
-				continue;
-			}
-			format.resize(file.tellg());
-			file.seekg(0);
-			file.read(format.data(), format.size());
-			file.close();
-		}
-
-		std::string result = FormatStr(format, replacements);
-
-		{
-			std::filesystem::create_directories(std::filesystem::path { tmpl.second }.parent_path());
-			std::ofstream file(tmpl.second);
-			if (!file)
-			{
-				std::cerr << "Failed to open '" << tmpl.second << "'\n";
-				continue;
-			}
-			file << result;
-			file.close();
-		}
-	}
+	GenerateTemplates(templates, replacements);
 }
\ No newline at end of file
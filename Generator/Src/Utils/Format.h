@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Replaces every '$ID$' in 'format' with the matching replacement, unknown IDs are removed
+std::string FormatStr(std::string_view format, const std::vector<std::pair<std::string, std::string>>& replacements);
+
+// Writes 'format' with replacements applied to 'output' for every { template, output } pair
+void GenerateTemplates(const std::vector<std::pair<std::string, std::string>>& templates, const std::vector<std::pair<std::string, std::string>>& replacements);
\ No newline at end of file
@@ -1,3 +1,8 @@
+newoption({
+	trigger     = "parser-profiling",
+	description = "Count attempts, tokens, nodes and time per parser rule"
+})
+
 workspace("Frertex")
 	common:addConfigs()
 	common:addBuildDefines()
@@ -9,6 +14,10 @@ workspace("Frertex")
 
 	startproject("CLI")
 
+	filter("options:parser-profiling")
+		defines({ "FRERTEX_PARSER_PROFILING=1" })
+	filter({})
+
 	group("Libs")
 	project("Frertex")
 		location("Frertex/")